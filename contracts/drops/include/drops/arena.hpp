@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef DROPS_DEBUG_MEMORY
+#include <eosio/print.hpp>
+#endif
+
+namespace dropssystem {
+
+/*
+
+ Scratch arena
+
+ The WASM heap never releases memory while an action runs, so every temporary
+ container grows linear memory for the rest of the action. Temporaries that
+ only live for part of an action are allocated from a fixed scratch buffer
+ instead. The buffer is taken from the heap on first use, so it is not part of
+ the contract binary and actions that never use it do not pay for it. A
+ scratch_scope hands the space allocated inside it back to the arena when it
+ ends, so later temporaries reuse it. Allocations that do not fit in the
+ buffer fall back to the heap.
+
+ Building with DROPS_DEBUG_MEMORY makes every memory_report print the peak
+ linear memory and scratch buffer use of the action when it ends.
+
+*/
+
+class scratch_arena
+{
+public:
+   static constexpr size_t capacity = 32 * 1024;
+
+   static void* allocate(size_t bytes, size_t align)
+   {
+      if (buffer == nullptr) {
+         buffer = static_cast<char*>(::operator new(capacity));
+      }
+      // Aligned by address, the heap only guarantees the alignment of max_align_t
+      const uintptr_t base  = reinterpret_cast<uintptr_t>(buffer);
+      const size_t    start = ((base + offset + align - 1) & ~uintptr_t(align - 1)) - base;
+      if (start + bytes > capacity) {
+         return ::operator new(bytes);
+      }
+      offset = start + bytes;
+      peak   = offset > peak ? offset : peak;
+      return buffer + start;
+   }
+
+   // Scratch memory is released by scratch_scope, only heap fallbacks are freed
+   static void deallocate(void* ptr)
+   {
+      const char* bytes = static_cast<const char*>(ptr);
+      if (buffer == nullptr || bytes < buffer || bytes >= buffer + capacity) {
+         ::operator delete(ptr);
+      }
+   }
+
+   static size_t high_water() { return peak; }
+
+private:
+   friend class scratch_scope;
+
+   static inline char*  buffer = nullptr;
+   static inline size_t offset = 0;
+   static inline size_t peak   = 0;
+};
+
+// Releases everything allocated from the arena while it was alive. Containers
+// using the arena must be declared after the scope so they are destroyed first.
+class scratch_scope
+{
+public:
+   scratch_scope()
+      : start(scratch_arena::offset)
+   {}
+   ~scratch_scope() { scratch_arena::offset = start; }
+
+   scratch_scope(const scratch_scope&)            = delete;
+   scratch_scope& operator=(const scratch_scope&) = delete;
+
+private:
+   size_t start;
+};
+
+template <typename T> struct scratch_allocator
+{
+   using value_type = T;
+
+   scratch_allocator() = default;
+   template <typename U> scratch_allocator(const scratch_allocator<U>&) {}
+
+   T*   allocate(size_t n) { return static_cast<T*>(scratch_arena::allocate(n * sizeof(T), alignof(T))); }
+   void deallocate(T* ptr, size_t) { scratch_arena::deallocate(ptr); }
+
+   template <typename U> bool operator==(const scratch_allocator<U>&) const { return true; }
+   template <typename U> bool operator!=(const scratch_allocator<U>&) const { return false; }
+};
+
+template <typename T> using scratch_vector = std::vector<T, scratch_allocator<T>>;
+using scratch_string = std::basic_string<char, std::char_traits<char>, scratch_allocator<char>>;
+template <typename K, typename V>
+using scratch_map = std::map<K, V, std::less<K>, scratch_allocator<std::pair<const K, V>>>;
+
+#ifdef DROPS_DEBUG_MEMORY
+class memory_report
+{
+public:
+   ~memory_report()
+   {
+      eosio::print("peak linear memory: ", uint64_t(__builtin_wasm_memory_size(0)) * 65536,
+                   " bytes, scratch arena: ", uint64_t(scratch_arena::high_water()), " bytes\n");
+   }
+};
+#else
+class memory_report
+{};
+#endif
+
+} // namespace dropssystem
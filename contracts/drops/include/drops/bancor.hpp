@@ -0,0 +1,52 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+namespace eosiosystem {
+
+typedef __int128 int128_t;
+
+/*
+
+ Bancor conversions and RAM fees
+
+ The system contract's exchange_state and buyrambytes compute these in double
+ precision. Here they are computed with exact 128-bit integer arithmetic and
+ truncated toward zero, so the result only differs from the system contract
+ when its double rounding carries a quotient across an integer, by one unit.
+ tests/bancor_test.cpp checks both against each other.
+
+*/
+
+// Bancor input required to receive out from the output reserve, see
+// exchange_state::get_bancor_input
+inline int64_t get_bancor_input(int64_t out_reserve, int64_t inp_reserve, int64_t out)
+{
+   eosio::check(out < out_reserve, "RAM market does not have enough RAM for this purchase.");
+
+   const int128_t inp = int128_t(inp_reserve) * out / (out_reserve - out);
+   return inp < 0 ? 0 : int64_t(inp);
+}
+
+// Bancor output received for inp into the input reserve, see
+// exchange_state::get_bancor_output
+inline int64_t get_bancor_output(int64_t inp_reserve, int64_t out_reserve, int64_t inp)
+{
+   const int128_t out = int128_t(inp) * out_reserve / (int128_t(inp_reserve) + inp);
+   return out < 0 ? 0 : int64_t(out);
+}
+
+// Tokens buyrambytes charges for a cost before the fee, cost / 0.995
+inline int64_t add_ram_fee(int64_t cost)
+{
+   return int64_t(int128_t(cost) * 200 / 199);
+}
+
+// Tokens sellram pays out of proceeds, after a 0.5% fee rounded up. The system
+// contract computes this in integers too, so it matches exactly.
+inline int64_t subtract_ram_fee(int64_t proceeds)
+{
+   return proceeds - (proceeds + 199) / 200;
+}
+
+} // namespace eosiosystem
@@ -3,27 +3,91 @@
 #include <eosio.system/eosio.system.hpp>
 #include <eosio.token/eosio.token.hpp>
 
+#include <drops/arena.hpp>
 #include <drops/drops.hpp>
+#include <drops/ids.hpp>
+#include <drops/memo.hpp>
 #include <drops/ram.hpp>
+#include <drops/seed.hpp>
+#include <drops/visit.hpp>
 
 using namespace eosio;
 using namespace std;
 
 namespace dropssystem {
 
+// unit of work for a single action, defined in drops.cpp
+class action_context;
+
 static constexpr name drops_contract  = "seed.gm"_n;   // location of drops contract
 static constexpr name oracle_contract = "oracle.gm"_n; // location of oracle contract
 
 // drops table row bytes costs
-static constexpr uint64_t primary_row     = 145;                           // size to create a row
-static constexpr uint64_t secondary_index = 144;                           // size of secondary index
+static constexpr uint64_t primary_row     = 137;                           // size to create a row
+static constexpr uint64_t secondary_index = 136;                           // size of secondary index
 static constexpr uint64_t record_size     = primary_row + secondary_index; // total record size
 
-// account table row bytes cost
-static constexpr uint64_t accounts_row = 124;
+// drop storage modes
+static constexpr uint8_t storage_global = 0; // drops in the contract scope, indexed by owner
+static constexpr uint8_t storage_owner  = 1; // drops scoped by owner, seeds tracked in the seed table
+
+// seed table row bytes cost, replaces the owner index in storage_owner mode
+static constexpr uint64_t seeds_row = 128;
+
+// bytes cost of the table created with the first drop in the scope of an owner
+// in storage_owner mode, billed to the payer of that drop
+static constexpr uint64_t owner_scope_table = 108;
+
+// total bytes cost of a drop in the given storage mode
+static constexpr uint64_t drop_record_size(uint8_t storage)
+{
+   return storage == storage_owner ? primary_row + seeds_row : record_size;
+}
+
+// serialized size of a drops table row written before the v2 layout
+static constexpr uint32_t drop_v1_size = 33;
+
+// serialized size of a drops table row in the v2 layout
+static constexpr uint32_t drop_v2_size = 25;
+
+// drops table layouts, recorded in the state once every row uses it
+static constexpr uint8_t drop_layout_v1 = 1;
+static constexpr uint8_t drop_layout_v2 = 2;
+
+// seed of the drop given to Greymass by init
+static constexpr uint64_t greymass_seed = 7338027470446133248;
+
+// account table row bytes cost, including the epochs length and payer
+static constexpr uint64_t accounts_row = 133;
+
+// bytes cost of each epoch entry held in an account row
+static constexpr uint64_t account_epochs_row = 12;
+
+// balance table row bytes cost
+static constexpr uint64_t balances_row = 137;
 
-// stat table row bytes cost
-static constexpr uint64_t stats_row = 412;
+// Unbind requests are stored in pages of this many drop ids, and at most
+// unbind_pages_max pages are completed by a single action
+static constexpr uint32_t unbind_page_size = 500;
+static constexpr uint32_t unbind_pages_max = 4;
+
+// maximum number of drops a selector examines in one action
+static constexpr uint32_t select_scan_max = 10000;
+
+// mint job table row bytes cost, excluding the length of the job data
+static constexpr uint64_t mintjobs_row = 150;
+
+// Maximum number of drops created in a single action, larger requests are
+// queued in a mint job and continued with resumemint
+static constexpr uint32_t generate_batch_max = 5000;
+
+// RAM bytes freed by bind and destroy that are pooled before they are sold
+static constexpr uint64_t ram_pool_threshold = 65536;
+
+// RAM bytes the contract keeps on hand for new drops, once the inventory would
+// drop below the low mark it is refilled with a single bulk purchase
+static constexpr uint64_t ram_inventory_low    = 65536;
+static constexpr uint64_t ram_inventory_refill = 1048576;
 
 // Additional RAM bytes to purchase (buyrambytes bug)
 static constexpr uint64_t purchase_buffer = 1;
@@ -52,11 +116,78 @@ public:
 
    */
 
-   struct [[eosio::table("account")]] account_row
+   struct account_epoch
    {
-      name     account;
+      uint64_t epoch;
       uint32_t drops;
+   };
+
+   struct [[eosio::table("account")]] account_row
+   {
+      name                                                account;
+      uint32_t                                            drops;
+      eosio::binary_extension<std::vector<account_epoch>> epochs; // drops held per epoch, sorted by epoch
+      eosio::binary_extension<name>                       payer;  // account billed for the row, unknown when absent
       uint64_t primary_key() const { return account.value; }
+      name     ram_payer() const { return payer.has_value() ? payer.value() : name(); }
+
+      // Extensions are serialized in order, the epochs must be present to record the payer
+      void set_payer(name ram_payer)
+      {
+         if (!epochs.has_value()) {
+            epochs.emplace();
+         }
+         payer.emplace(ram_payer);
+      }
+
+      // Position of the entry for an epoch, or where it would be inserted
+      template <typename Entries>
+      static auto find_epoch(Entries& entries, uint64_t epoch)
+      {
+         return std::lower_bound(entries.begin(), entries.end(), epoch,
+                                 [](const account_epoch& entry, uint64_t value) { return entry.epoch < value; });
+      }
+
+      // Drops held from the given epoch, epochs without drops have no entry
+      uint32_t epoch_drops(uint64_t epoch) const
+      {
+         if (!epochs.has_value()) {
+            return 0;
+         }
+         auto entry = find_epoch(epochs.value(), epoch);
+         return entry != epochs.value().end() && entry->epoch == epoch ? entry->drops : 0;
+      }
+
+      // Adds drops to both the lifetime total and the epoch entry, returns the epoch total
+      uint32_t add_drops(uint64_t epoch, uint32_t amount)
+      {
+         if (!epochs.has_value()) {
+            epochs.emplace();
+         }
+         drops += amount;
+         auto& entries = epochs.value();
+         auto  entry   = find_epoch(entries, epoch);
+         if (entry == entries.end() || entry->epoch != epoch) {
+            entry = entries.insert(entry, {epoch, 0});
+         }
+         entry->drops += amount;
+         return entry->drops;
+      }
+
+      // Removes drops from both the lifetime total and the epoch entry
+      void remove_drops(uint64_t epoch, uint32_t amount)
+      {
+         check(epochs.has_value(), "Account has no drops recorded by epoch.");
+         auto& entries = epochs.value();
+         auto  entry   = find_epoch(entries, epoch);
+         check(entry != entries.end() && entry->epoch == epoch && entry->drops >= amount,
+               "Account does not hold enough drops from this epoch.");
+         drops -= amount;
+         entry->drops -= amount;
+         if (entry->drops == 0) {
+            entries.erase(entry);
+         }
+      }
    };
 
    struct [[eosio::table("epoch")]] epoch_row
@@ -69,23 +200,93 @@ public:
 
    struct [[eosio::table("drop")]] drop_row
    {
-      uint64_t          seed;
-      uint64_t          epoch;
-      name              owner;
-      eosio::time_point created;
-      bool              bound;
-      uint64_t          primary_key() const { return seed; }
-      uint128_t         by_owner() const { return ((uint128_t)owner.value << 64) | seed; }
+      uint64_t              seed;
+      uint32_t              epoch;
+      name                  owner;
+      eosio::time_point_sec created;
+      bool                  bound;
+      uint64_t              primary_key() const { return seed; }
+      uint64_t              by_owner() const { return owner.value; }
+
+      // Rows written before the v2 layout stored the epoch as a uint64_t and the
+      // creation time as a time_point. Both layouts are read so the table stays
+      // readable while migratedrops rewrites it.
+      template <typename DataStream>
+      friend DataStream& operator>>(DataStream& ds, drop_row& row)
+      {
+         if (ds.remaining() == drop_v1_size) {
+            uint64_t          epoch;
+            eosio::time_point created;
+            ds >> row.seed >> epoch >> row.owner >> created >> row.bound;
+            row.epoch   = epoch;
+            row.created = eosio::time_point_sec(created);
+         } else {
+            ds >> row.seed >> row.epoch >> row.owner >> row.created >> row.bound;
+         }
+         return ds;
+      }
+
+      template <typename DataStream>
+      friend DataStream& operator<<(DataStream& ds, const drop_row& row)
+      {
+         return ds << row.seed << row.epoch << row.owner << row.created << row.bound;
+      }
+   };
+
+   // ABI description of the ownerdrop table used in storage_owner mode, its rows
+   // are read and written as drop_row
+   struct [[eosio::table("ownerdrop")]] owner_drop_row : drop_row
+   {};
+
+   struct [[eosio::table("seed")]] seed_row
+   {
+      uint64_t seed;
+      name     owner;
+      uint64_t primary_key() const { return seed; }
    };
 
    struct [[eosio::table("state")]] state_row
    {
-      uint16_t id;
-      uint64_t epoch;
-      bool     enabled;
-      uint64_t primary_key() const { return id; }
+      uint16_t                          id;
+      uint64_t                          epoch;
+      bool                              enabled;
+      eosio::binary_extension<uint8_t>  generation;    // seed generation mode, generation_v1 when absent
+      eosio::binary_extension<uint8_t>  storage;       // drop storage mode, storage_global when absent
+      eosio::binary_extension<uint64_t> ram_pool;      // freed RAM bytes not sold yet
+      eosio::binary_extension<uint64_t> ram_inventory; // bought RAM bytes not allocated yet
+      eosio::binary_extension<asset>    ram_price;     // quote for ram_inventory_refill bytes at the last refill
+      eosio::binary_extension<uint8_t>  drop_layout;   // layout of every drops table row, drop_layout_v1 when absent
+      eosio::binary_extension<asset>    owed;          // EOS held for the balance rows
+      uint64_t                          primary_key() const { return id; }
+      uint8_t                           generation_mode() const
+      {
+         return generation.has_value() ? generation.value() : generation_v1;
+      }
+      uint8_t  storage_mode() const { return storage.has_value() ? storage.value() : storage_global; }
+      uint64_t ram_pooled() const { return ram_pool.has_value() ? ram_pool.value() : 0; }
+      uint64_t ram_available() const { return ram_inventory.has_value() ? ram_inventory.value() : 0; }
+      uint8_t  drop_layout_version() const { return drop_layout.has_value() ? drop_layout.value() : drop_layout_v1; }
+      asset    owed_balances() const { return owed.has_value() ? owed.value() : asset{0, EOS}; }
+
+      // Whether reconcileram or a refill recorded the inventory and its price
+      bool ram_inventory_ready() const { return ram_price.has_value() && ram_price.value().amount > 0; }
+
+      // Extensions are serialized in order, so writing one requires every
+      // extension before it to hold a value
+      void extend()
+      {
+         generation.emplace(generation_mode());
+         storage.emplace(storage_mode());
+         ram_pool.emplace(ram_pooled());
+         ram_inventory.emplace(ram_available());
+         ram_price.emplace(ram_price.has_value() ? ram_price.value() : asset{0, EOS});
+         drop_layout.emplace(drop_layout_version());
+         owed.emplace(owed_balances());
+      }
    };
 
+   // Per epoch stats written before they were merged into the account row, only
+   // read by migratestats
    struct [[eosio::table("stat")]] stat_row
    {
       uint64_t  id;
@@ -97,6 +298,7 @@ public:
       uint128_t by_account_epoch() const { return (uint128_t)account.value << 64 | epoch; }
    };
 
+   // Unbind requests stored before they were paged, drained before any page
    struct [[eosio::table("unbind")]] unbind_row
    {
       name                  owner;
@@ -104,6 +306,37 @@ public:
       uint64_t              primary_key() const { return owner.value; }
    };
 
+   // One page of the unbind request of an owner, scoped by owner
+   struct [[eosio::table("unbindpage")]] unbind_page_row
+   {
+      uint64_t              page;
+      std::vector<uint64_t> drops_ids;
+      uint64_t              primary_key() const { return page; }
+   };
+
+   // Refunds and RAM proceeds owed to an account, withdrawn with claim. Accounts
+   // with autopay set are paid with an inline transfer instead.
+   struct [[eosio::table("balance")]] balance_row
+   {
+      name     account;
+      asset    balance;
+      bool     autopay;
+      uint64_t primary_key() const { return account.value; }
+   };
+
+   struct [[eosio::table("mintjob")]] mintjob_row
+   {
+      name     owner;
+      uint64_t epoch;
+      uint32_t amount;     // total drops requested
+      uint32_t minted;     // drops created so far
+      uint64_t cursor;     // next seed derivation index
+      uint8_t  generation; // seed generation mode the job was created with
+      bool     bound;
+      string   data;
+      uint64_t primary_key() const { return owner.value; }
+   };
+
    /*
 
    Indices
@@ -115,16 +348,52 @@ public:
    typedef eosio::multi_index<
       "drop"_n,
       drop_row,
-      eosio::indexed_by<"owner"_n, eosio::const_mem_fun<drop_row, uint128_t, &drop_row::by_owner>>>
-                                                    drop_table;
-   typedef eosio::multi_index<"state"_n, state_row> state_table;
+      eosio::indexed_by<"owner"_n, eosio::const_mem_fun<drop_row, uint64_t, &drop_row::by_owner>>>
+                                                       drop_table;
+   typedef eosio::multi_index<"ownerdrop"_n, drop_row> owner_drop_table;
+   typedef eosio::multi_index<"seed"_n, seed_row>      seed_table;
+   typedef eosio::multi_index<"state"_n, state_row>    state_table;
    typedef eosio::multi_index<
       "stat"_n,
       stat_row,
       eosio::indexed_by<"account"_n, eosio::const_mem_fun<stat_row, uint64_t, &stat_row::by_account>>,
       eosio::indexed_by<"accountepoch"_n, eosio::const_mem_fun<stat_row, uint128_t, &stat_row::by_account_epoch>>>
                                                       stat_table;
-   typedef eosio::multi_index<"unbind"_n, unbind_row> unbind_table;
+   typedef eosio::multi_index<"unbind"_n, unbind_row>          unbind_table;
+   typedef eosio::multi_index<"unbindpage"_n, unbind_page_row> unbind_page_table;
+   typedef eosio::multi_index<"balance"_n, balance_row>        balance_table;
+   typedef eosio::multi_index<"mintjob"_n, mintjob_row>        mintjob_table;
+
+   /*
+
+    Action parameter structs
+
+   */
+
+   // Selects drops of an owner by bound flag and an inclusive epoch range.
+   // Pass the next value of the previous selection as the cursor to continue.
+   struct drop_selector
+   {
+      bool     bound;
+      uint32_t epoch_start;
+      uint32_t epoch_end;
+      uint32_t limit;
+      uint64_t cursor;
+   };
+
+   // Drops sent to one recipient of transfermany
+   struct transfer_group
+   {
+      name                  to;
+      std::vector<uint64_t> drops_ids;
+   };
+
+   // Drops minted for one recipient of mintmany
+   struct mint_recipient
+   {
+      name     owner;
+      uint32_t amount;
+   };
 
    /*
 
@@ -140,6 +409,17 @@ public:
       asset    refund;
       uint64_t total_drops;
       uint64_t epoch_drops;
+      uint8_t  generation;
+      uint32_t collisions;
+   };
+
+   struct mintmany_return_value
+   {
+      uint32_t drops;
+      uint32_t recipients;
+      uint64_t epoch;
+      uint8_t  generation;
+      uint32_t collisions;
    };
 
    struct destroy_return_value
@@ -155,6 +435,33 @@ public:
       asset    redeemed;
    };
 
+   struct migrate_return_value
+   {
+      uint32_t migrated;
+      uint64_t next;
+      bool     completed;
+   };
+
+   struct selection_return_value
+   {
+      uint32_t drops;
+      uint64_t next;
+      bool     completed;
+   };
+
+   struct account_stats_return_value
+   {
+      name                       account;
+      uint32_t                   drops;
+      std::vector<account_epoch> epochs;
+   };
+
+   struct generate_quote_return_value
+   {
+      uint64_t ram_bytes; // RAM allocated by the generate
+      asset    cost;      // EOS the generate charges for it
+   };
+
    /*
 
     User actions
@@ -165,22 +472,68 @@ public:
    generate(name from, name to, asset quantity, std::string memo);
 
    [[eosio::action]] generate_return_value mint(name owner, uint32_t amount, std::string data);
-
-   [[eosio::action]] void transfer(name from, name to, std::vector<uint64_t> drops_ids, string memo);
-
-   [[eosio::action]] destroy_return_value destroy(name owner, std::vector<uint64_t> drops_ids, string memo);
-
-   [[eosio::action]] bind_return_value bind(name owner, std::vector<uint64_t> drops_ids);
-   [[eosio::action]] void              unbind(name owner, std::vector<uint64_t> drops_ids);
-   [[eosio::action]] void              cancelunbind(name owner);
+   [[eosio::action]] generate_return_value resumemint(name owner, uint32_t max);
+   [[eosio::action]] asset                 cancelmint(name owner);
+   [[eosio::action]] generate_return_value gencredit(name owner, uint32_t amount, std::string data);
+   [[eosio::action]] mintmany_return_value
+   mintmany(name payer, std::vector<mint_recipient> recipients, std::string data);
+
+   [[eosio::action]] void                   transfer(name from, name to, std::vector<uint64_t> drops_ids, string memo);
+   [[eosio::action]] void                   transferpack(name from, name to, std::vector<char> drops_ids, string memo);
+   [[eosio::action]] selection_return_value transfersel(name from, name to, drop_selector selector, string memo);
+   [[eosio::action]] void                   transfermany(name from, std::vector<transfer_group> groups, string memo);
+
+   [[eosio::action]] destroy_return_value   destroy(name owner, std::vector<uint64_t> drops_ids, string memo);
+   [[eosio::action]] destroy_return_value   destroypack(name owner, std::vector<char> drops_ids, string memo);
+   [[eosio::action]] selection_return_value destroysel(name owner, drop_selector selector, string memo);
+
+   [[eosio::action]] bind_return_value      bind(name owner, std::vector<uint64_t> drops_ids);
+   [[eosio::action]] bind_return_value      bindpack(name owner, std::vector<char> drops_ids);
+   [[eosio::action]] selection_return_value bindsel(name owner, drop_selector selector);
+   [[eosio::action]] void                   unbind(name owner, std::vector<uint64_t> drops_ids);
+   [[eosio::action]] void                   unbindpack(name owner, std::vector<char> drops_ids);
+   [[eosio::action]] void                   cancelunbind(name owner);
+   [[eosio::action]] generate_return_value  unbindcredit(name owner);
+   [[eosio::action]] generate_return_value  unbindnow(name owner, std::vector<uint64_t> drops_ids);
 
    using generate_action     = eosio::action_wrapper<"generate"_n, &drops::generate>;
    using mint_action         = eosio::action_wrapper<"mint"_n, &drops::mint>;
+   using resumemint_action   = eosio::action_wrapper<"resumemint"_n, &drops::resumemint>;
+   using cancelmint_action   = eosio::action_wrapper<"cancelmint"_n, &drops::cancelmint>;
+   using mintmany_action     = eosio::action_wrapper<"mintmany"_n, &drops::mintmany>;
+   using gencredit_action    = eosio::action_wrapper<"gencredit"_n, &drops::gencredit>;
    using transfer_action     = eosio::action_wrapper<"transfer"_n, &drops::transfer>;
+   using transferpack_action = eosio::action_wrapper<"transferpack"_n, &drops::transferpack>;
+   using transfersel_action  = eosio::action_wrapper<"transfersel"_n, &drops::transfersel>;
+   using transfermany_action = eosio::action_wrapper<"transfermany"_n, &drops::transfermany>;
    using destroy_action      = eosio::action_wrapper<"destroy"_n, &drops::destroy>;
+   using destroypack_action  = eosio::action_wrapper<"destroypack"_n, &drops::destroypack>;
+   using destroysel_action   = eosio::action_wrapper<"destroysel"_n, &drops::destroysel>;
    using bind_action         = eosio::action_wrapper<"bind"_n, &drops::bind>;
+   using bindpack_action     = eosio::action_wrapper<"bindpack"_n, &drops::bindpack>;
+   using bindsel_action      = eosio::action_wrapper<"bindsel"_n, &drops::bindsel>;
    using unbind_action       = eosio::action_wrapper<"unbind"_n, &drops::unbind>;
+   using unbindpack_action   = eosio::action_wrapper<"unbindpack"_n, &drops::unbindpack>;
    using cancelunbind_action = eosio::action_wrapper<"cancelunbind"_n, &drops::cancelunbind>;
+   using unbindcredit_action = eosio::action_wrapper<"unbindcredit"_n, &drops::unbindcredit>;
+   using unbindnow_action    = eosio::action_wrapper<"unbindnow"_n, &drops::unbindnow>;
+
+   [[eosio::action, eosio::read_only]] account_stats_return_value accountstats(name account);
+   using accountstats_action = eosio::action_wrapper<"accountstats"_n, &drops::accountstats>;
+
+   [[eosio::action, eosio::read_only]] generate_quote_return_value
+   genquote(name owner, uint32_t amount, uint32_t data_length);
+   using genquote_action = eosio::action_wrapper<"genquote"_n, &drops::genquote>;
+
+   [[eosio::action]] uint64_t sellpool();
+   [[eosio::action]] uint64_t refillram();
+   using sellpool_action  = eosio::action_wrapper<"sellpool"_n, &drops::sellpool>;
+   using refillram_action = eosio::action_wrapper<"refillram"_n, &drops::refillram>;
+
+   [[eosio::action]] asset claim(name account);
+   [[eosio::action]] void  setautopay(name account, bool autopay);
+   using claim_action      = eosio::action_wrapper<"claim"_n, &drops::claim>;
+   using setautopay_action = eosio::action_wrapper<"setautopay"_n, &drops::setautopay>;
 
    /*
 
@@ -203,6 +556,21 @@ public:
    [[eosio::action]] void init();
    using init_action = eosio::action_wrapper<"init"_n, &drops::init>;
 
+   [[eosio::action]] void setgenmode(uint8_t generation);
+   using setgenmode_action = eosio::action_wrapper<"setgenmode"_n, &drops::setgenmode>;
+
+   [[eosio::action]] void reconcileram(uint64_t unused_bytes);
+   using reconcileram_action = eosio::action_wrapper<"reconcileram"_n, &drops::reconcileram>;
+
+   [[eosio::action]] void setstorage(uint8_t storage);
+   using setstorage_action = eosio::action_wrapper<"setstorage"_n, &drops::setstorage>;
+
+   [[eosio::action]] migrate_return_value migratedrops(uint64_t start, uint32_t max);
+   using migratedrops_action = eosio::action_wrapper<"migratedrops"_n, &drops::migratedrops>;
+
+   [[eosio::action]] migrate_return_value migratestats(uint32_t max);
+   using migratestats_action = eosio::action_wrapper<"migratestats"_n, &drops::migratestats>;
+
    // Dummy action that'll help the ABI export the generate_return_value struct
    [[eosio::action]] generate_return_value generatertrn();
    using generatertrn_action = eosio::action_wrapper<"generatertrn"_n, &drops::generatertrn>;
@@ -225,10 +593,50 @@ public:
 private:
    drops::epoch_row advance_epoch();
 
-   generate_return_value do_generate(name from, name to, asset quantity, std::vector<std::string> parsed);
-   generate_return_value do_unbind(name from, name to, asset quantity, std::vector<std::string> parsed);
-
-   std::vector<std::string> split(const std::string& str, char delim);
+   generate_return_value do_generate(name from, name to, asset quantity, uint32_t amount, std::string_view data);
+   generate_return_value do_unbind(name from, name to, asset quantity, std::string_view data);
+   generate_return_value unbind_from_credit(action_context& ctx, name owner, std::vector<uint64_t> drops_ids);
+   generate_return_value do_deposit(name from, asset quantity);
+   void                  unbind_drops(action_context& ctx, name owner, std::vector<uint64_t> drops_ids);
+   std::vector<uint64_t> take_unbind_pages(name owner);
+
+   // Ids are either a std::vector<uint64_t> or packed_drop_ids
+   template <typename Ids> void                 do_transfer(action_context& ctx, name from, name to, const Ids& ids);
+   template <typename Ids> void                 transfer_drops(action_context& ctx, name from, name to, const Ids& ids);
+   template <typename Ids> bind_return_value    do_bind(action_context& ctx, name owner, const Ids& drops_ids);
+   template <typename Ids> destroy_return_value do_destroy(action_context& ctx, name owner, const Ids& drops_ids);
+
+   selection_return_value
+   select_drops(action_context& ctx, name owner, const drop_selector& selector, std::vector<uint64_t>& drops_ids);
+
+   uint32_t emplace_drops(uint8_t         storage,
+                          seed_generator& seeds,
+                          uint64_t&       cursor,
+                          uint32_t        amount,
+                          name            owner,
+                          uint64_t        epoch,
+                          bool            bound,
+                          name            ram_payer);
+
+   uint64_t owner_scope_ram(uint8_t storage, name owner);
+   uint64_t generate_ram(action_context& ctx, name owner, uint64_t epoch, uint32_t amount, size_t data_length);
+
+   name drop_payer(const drop_row& drop);
+   void set_owner_index_payer(uint64_t seed, name payer);
+
+   void pool_ram(action_context& ctx, uint64_t bytes, bool sell_now);
+
+   bool has_balance_row(name account);
+   bool pays_inline(name account);
+   void  debit(action_context& ctx, name account, asset quantity);
+   asset allocate_ram(action_context& ctx, uint64_t bytes);
+   asset release_ram(action_context& ctx, uint64_t bytes);
+   asset price_ram(action_context& ctx, uint64_t bytes);
+   asset quote_ram(action_context& ctx, uint64_t bytes);
+   asset buy_ram(action_context& ctx, uint64_t bytes);
+   void  refill_ram(action_context& ctx, uint64_t bytes);
+   void  credit(action_context& ctx, name account, asset quantity, name ram_payer, const std::string& memo);
+   asset credit_change(action_context& ctx, name account, asset change);
 };
 
 } // namespace dropssystem
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+#include <iterator>
+#include <vector>
+
+namespace dropssystem {
+
+/*
+
+ Packed drop ids
+
+ Actions ending in "pack" take their drop ids as bytes instead of a uint64[]:
+
+   <first id><delta><delta>...
+
+ Ids are sorted in strictly ascending order, every value after the first is the
+ difference to the previous id, and each value is written as an unsigned LEB128
+ varint. The list is decoded while it is iterated, no vector of ids is built.
+
+*/
+
+// Sort the ids and encode them as a packed drop id list, duplicate ids abort
+std::vector<char> pack_drop_ids(std::vector<uint64_t> ids);
+
+class packed_drop_ids
+{
+public:
+   class iterator
+   {
+   public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type        = uint64_t;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = const uint64_t*;
+      using reference         = const uint64_t&;
+
+      iterator() = default;
+      iterator(const char* pos, const char* end);
+
+      reference operator*() const { return id; }
+      iterator& operator++();
+      bool      operator==(const iterator& other) const { return current == other.current; }
+      bool      operator!=(const iterator& other) const { return current != other.current; }
+
+   private:
+      const char* current = nullptr; // start of the varint of the current id, nullptr once exhausted
+      const char* next    = nullptr; // start of the following varint
+      const char* end     = nullptr;
+      uint64_t    id      = 0;
+
+      void decode(bool first);
+   };
+
+   explicit packed_drop_ids(const std::vector<char>& data)
+      : data(data)
+   {}
+
+   iterator begin() const { return iterator(data.data(), data.data() + data.size()); }
+   iterator end() const { return iterator(); }
+
+   // Number of ids in the list, counted from the varint terminator bytes
+   size_t size() const;
+
+private:
+   const std::vector<char>& data;
+};
+
+} // namespace dropssystem
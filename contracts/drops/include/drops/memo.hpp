@@ -0,0 +1,53 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace dropssystem {
+
+/*
+
+ Memo commands
+
+ Token transfers to the contract carry one of the following memos:
+
+   <amount>,<data>   generate <amount> drops seeded with <data>
+   unbind            complete the pending unbind request of the sender
+   unbind,<ids>      unbind the comma separated drop ids of the sender
+   deposit           add the transfer to the RAM credit of the sender
+
+ The memo is parsed in a single pass over a string_view without allocating.
+ Commands are identified by their leading keyword, a memo starting with a digit
+ is a generate command. New commands are added to memo_commands.
+
+*/
+
+enum class memo_command : uint8_t
+{
+   generate,
+   unbind,
+   deposit,
+};
+
+struct parsed_memo
+{
+   memo_command     command;
+   uint32_t         amount; // generate: number of drops
+   std::string_view data;   // generate: seed data, unbind: drop ids
+};
+
+// Parse a transfer memo, aborting the action with a descriptive message when
+// the memo is malformed
+parsed_memo parse_memo(std::string_view memo);
+
+// Parse an unsigned decimal without sign, whitespace or trailing characters,
+// returning false when the value does not fit in a uint32_t
+bool parse_uint32(std::string_view str, uint32_t& value);
+
+// Parse a comma separated list of drop ids, aborting the action when an id is
+// not a valid number
+std::vector<uint64_t> parse_drop_ids(std::string_view list);
+
+} // namespace dropssystem
@@ -1,11 +1,42 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+
 namespace eosiosystem {
 
-int64_t get_bancor_input(int64_t out_reserve, int64_t inp_reserve, int64_t out);
+using eosio::asset;
+using eosio::symbol;
+
+/*
+
+ RAM market quote
+
+ Loads the system contract's rammarket row once, then prices any number of RAM
+ purchases and sales against it. The formulas are those of the system
+ contract's buyrambytes and sellram actions, computed in integer arithmetic
+ where the system contract uses doubles, so a quote can be one unit off the
+ amount those actions settle on, see drops/bancor.hpp.
+
+*/
+
+class ram_quote
+{
+public:
+   ram_quote(symbol core_symbol);
+
+   // Tokens required to buy bytes, before the RAM fee
+   asset cost(uint64_t bytes) const;
 
-asset ramcost(uint32_t bytes, symbol core_symbol);
+   // Tokens buyrambytes will charge for bytes, including the RAM fee
+   asset cost_with_fee(uint64_t bytes) const;
 
-asset ramcostwithfee(uint32_t bytes, symbol core_symbol);
+   // Tokens sellram will pay out for bytes, after the RAM fee
+   asset proceeds_minus_fee(uint64_t bytes) const;
 
-asset ramproceedstminusfee(uint32_t bytes, symbol core_symbol);
+private:
+   symbol  core_symbol;
+   int64_t ram_reserve;
+   int64_t eos_reserve;
+};
 
-} // namespace eosiosystem
\ No newline at end of file
+} // namespace eosiosystem
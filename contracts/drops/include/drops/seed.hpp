@@ -0,0 +1,60 @@
+#pragma once
+
+#include <eosio/crypto.hpp>
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+namespace dropssystem {
+
+/*
+
+ Seed derivation
+
+ generation_v1: the seed of drop <index> is the first 8 bytes of
+ sha256(<index><data>), where <index> is the decimal position of the drop within
+ its generation batch.
+
+ generation_v2: every digest yields four seeds. The seed of drop <index> is the
+ 8 byte word at position (<index> % 4) of sha256(v2:<index / 4><data>). The
+ "v2:" prefix keeps v2 digests apart from the v1 digest of the same number.
+
+ The generator keeps a single buffer holding the data, writes each index and
+ prefix in place directly in front of it and hashes the result, so deriving a
+ seed performs no allocation.
+
+*/
+
+static constexpr uint8_t generation_v1 = 1; // one seed per sha256 digest
+static constexpr uint8_t generation_v2 = 2; // four seeds per sha256 digest
+
+class seed_generator
+{
+public:
+   seed_generator(std::string_view data, uint8_t generation = generation_v1);
+
+   uint64_t derive(uint64_t index);
+
+private:
+   // Number of decimal digits in the largest uint64_t
+   static constexpr size_t max_digits = 20;
+
+   // Domain prefix written in front of the index in generation_v2
+   static constexpr std::string_view v2_prefix = "v2:";
+
+   // Number of seeds taken from each digest in generation_v2
+   static constexpr uint64_t seeds_per_digest = 4;
+
+   std::array<uint8_t, 32> hash(uint64_t index);
+
+   uint8_t           generation;
+   std::vector<char> buffer;
+
+   // Most recent digest, reused by generation_v2 for consecutive indices
+   uint64_t                digest_index;
+   bool                    digest_cached = false;
+   std::array<uint8_t, 32> digest;
+};
+
+} // namespace dropssystem
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+#include <cstdint>
+
+namespace dropssystem {
+
+/*
+
+ Visiting drops by id
+
+ Actions that name their drops by id visit them through for_each_drop, which
+ walks strictly ascending ids in a single pass over a table, and validate each
+ drop with check_drop. Failures only format their message in fail_drop, so
+ drops that pass never build a string.
+
+*/
+
+// Failures of the checks run for every drop an action touches
+enum class drop_error : uint8_t
+{
+   duplicate,
+   not_found,
+   not_owned,
+   not_owned_transfer,
+   not_bound,
+   already_bound,
+   bound_transfer,
+   no_owner_index,
+};
+
+// Aborts the action with the message of the error for the drop
+[[noreturn]] __attribute__((noinline, cold)) void fail_drop(drop_error error, uint64_t seed);
+
+inline void check_drop(bool condition, drop_error error, uint64_t seed)
+{
+   if (!condition) {
+      fail_drop(error, seed);
+   }
+}
+
+// Visits the drops of ascending ids in a single pass over the table. visit
+// receives the iterator of each drop and returns the iterator of the row after
+// it, or end() when that is not known. Whenever that row is the next id it is
+// used directly instead of looking the id up again, which is the common case
+// for the drops of one owner in storage_owner mode. The seeds of one owner are
+// spread over the global table, so in storage_global every id is looked up.
+// Ids must be strictly ascending, so a repeated id aborts the action.
+template <typename Table, typename Ids, typename Visit>
+void for_each_drop(Table& drops, const Ids& drops_ids, Visit&& visit)
+{
+   auto     next     = drops.end();
+   uint64_t previous = 0;
+   bool     first    = true;
+   for (uint64_t id : drops_ids) {
+      check_drop(first || id > previous, drop_error::duplicate, id);
+      first    = false;
+      previous = id;
+
+      auto drops_itr = next != drops.end() && next->seed == id ? next : drops.lower_bound(id);
+      check_drop(drops_itr != drops.end() && drops_itr->seed == id, drop_error::not_found, id);
+      next = visit(drops_itr);
+   }
+}
+
+} // namespace dropssystem
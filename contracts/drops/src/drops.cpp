@@ -2,11 +2,256 @@
 
 namespace dropssystem {
 
+namespace {
+
+// Writes new drop rows straight to the database. multi_index keeps every row
+// it emplaces in memory until the action ends, which for a full batch costs
+// more than the rows themselves. Rows written here are serialized into one
+// reused buffer and never cached.
+class drop_writer
+{
+public:
+   drop_writer(name code, uint8_t storage, name owner)
+      : code(code.value)
+      , storage(storage)
+      , scope(storage == storage_owner ? owner.value : code.value)
+   {}
+
+   // Whether a drop with this seed exists in any scope
+   bool exists(uint64_t seed) const
+   {
+      using namespace eosio::internal_use_do_not_use;
+      const uint64_t table = storage == storage_owner ? "seed"_n.value : "drop"_n.value;
+      return db_find_i64(code, code, table, seed) >= 0;
+   }
+
+   void store(const drops::drop_row& drop, name payer)
+   {
+      using namespace eosio::internal_use_do_not_use;
+      datastream<char*> ds(buffer, sizeof(buffer));
+      ds << drop;
+      if (storage == storage_owner) {
+         db_store_i64(scope, "ownerdrop"_n.value, payer.value, drop.seed, buffer, sizeof(buffer));
+
+         // Record the owner of the seed, laid out as a seed_row
+         char              seed_buffer[sizeof(uint64_t) + sizeof(name)];
+         datastream<char*> seed_ds(seed_buffer, sizeof(seed_buffer));
+         seed_ds << drop.seed << drop.owner;
+         db_store_i64(code, "seed"_n.value, payer.value, drop.seed, seed_buffer, sizeof(seed_buffer));
+      } else {
+         db_store_i64(scope, "drop"_n.value, payer.value, drop.seed, buffer, sizeof(buffer));
+
+         // multi_index stores secondary index 0 of a table under this name
+         const uint64_t owner_key = drop.by_owner();
+         db_idx64_store(scope, "drop"_n.value & 0xFFFFFFFFFFFFFFF0ULL, payer.value, drop.seed, &owner_key);
+      }
+   }
+
+private:
+   uint64_t code;
+   uint8_t  storage;
+   uint64_t scope;
+   char     buffer[drop_v2_size];
+};
+
+// Share of a ram_inventory_refill quote for bytes, rounded up so allocations
+// never cost less than the RAM they use
+asset price_allocation(asset refill_price, uint64_t bytes)
+{
+   const uint128_t share = uint128_t(refill_price.amount) * bytes + ram_inventory_refill - 1;
+   return asset{int64_t(share / ram_inventory_refill), EOS};
+}
+
+} // namespace
+
+// Unit of work shared by everything that serves one action. The contract state
+// and account rows are read at most once, changes to the drops held by each
+// account are collected per account and epoch, and flush() writes every
+// touched account row exactly once.
+class action_context
+{
+public:
+   explicit action_context(name self)
+      : self(self)
+      , states(self, self.value)
+      , accounts(self, self.value)
+   {}
+
+   // State as changed by this action so far
+   const drops::state_row& state()
+   {
+      if (!state_loaded) {
+         state_itr    = states.require_find(1, "Contract state does not exist.");
+         state_value  = *state_itr;
+         state_loaded = true;
+      }
+      return state_value;
+   }
+
+   // Changes are kept in memory and written once by flush
+   template <typename Lambda> void update_state(Lambda&& updater)
+   {
+      state();
+      updater(state_value);
+      state_changed = true;
+   }
+
+   // Account row as last written, nullptr when the account has none
+   const drops::account_row* account(name owner)
+   {
+      auto account_itr = find_account(owner);
+      return account_itr != accounts.end() ? &*account_itr : nullptr;
+   }
+
+   // Bytes billed to ram_payer when the account row of owner gains drops from
+   // an epoch. A row paid for by another account moves to ram_payer as a whole.
+   uint64_t account_ram(name owner, uint64_t epoch, name ram_payer)
+   {
+      const drops::account_row* row = account(owner);
+      if (!row) {
+         return accounts_row + account_epochs_row;
+      }
+      if (row->epoch_drops(epoch) > 0) {
+         return 0;
+      }
+      if (row->ram_payer() == ram_payer) {
+         return account_epochs_row;
+      }
+      const uint64_t entries = row->epochs.has_value() ? row->epochs.value().size() : 0;
+      return accounts_row + (entries + 1) * account_epochs_row;
+   }
+
+   // EOS sent out by inline transfers of this action
+   void pay_out(asset quantity) { paid_out += quantity.amount; }
+
+   // EOS spent buying RAM by inline actions of this action
+   void spend_on_ram(asset cost) { ram_spent += cost.amount; }
+
+   // Records a change in the drops an account holds from an epoch
+   void add_drops(name owner, uint64_t epoch, int64_t amount)
+   {
+      auto delta = std::lower_bound(deltas.begin(), deltas.end(), std::make_pair(owner, epoch),
+                                    [](const account_delta& delta, const std::pair<name, uint64_t>& key) {
+                                       return std::make_pair(delta.owner, delta.epoch) < key;
+                                    });
+      if (delta == deltas.end() || delta->owner != owner || delta->epoch != epoch) {
+         delta = deltas.insert(delta, {owner, epoch, 0});
+      }
+      delta->drops += amount;
+   }
+
+   // Writes the collected changes, the state row at most once. Account rows
+   // that are created are billed to ram_payer. Rows that gain an epoch entry
+   // grow on ram_payer, moving to it when another account paid for them, see
+   // account_ram. Every other row keeps its payer.
+   void flush(name ram_payer)
+   {
+      for (auto first = deltas.begin(); first != deltas.end();) {
+         const name owner = first->owner;
+         const auto last =
+            std::find_if(first, deltas.end(), [&](const account_delta& delta) { return delta.owner != owner; });
+
+         auto apply = [&](drops::account_row& row) {
+            for (auto delta = first; delta != last; ++delta) {
+               if (delta->drops > 0) {
+                  row.add_drops(delta->epoch, delta->drops);
+               } else if (delta->drops < 0) {
+                  row.remove_drops(delta->epoch, -delta->drops);
+               }
+            }
+         };
+
+         auto account_itr = find_account(owner);
+         if (account_itr == accounts.end()) {
+            account_itr = accounts.emplace(ram_payer, [&](auto& row) {
+               row.account = owner;
+               row.drops   = 0;
+               apply(row);
+               row.set_payer(ram_payer);
+            });
+            cache_account(owner, account_itr);
+         } else {
+            const bool grows = std::any_of(first, last, [&](const account_delta& delta) {
+               return delta.drops > 0 && account_itr->epoch_drops(delta.epoch) == 0;
+            });
+            const bool moves = grows && account_itr->ram_payer() != ram_payer;
+            accounts.modify(account_itr, moves ? ram_payer : same_payer, [&](auto& row) {
+               apply(row);
+               if (moves) {
+                  row.set_payer(ram_payer);
+               }
+            });
+         }
+         first = last;
+      }
+      deltas.clear();
+
+      // RAM is only bought with EOS no balance row is owed, pooled RAM counts
+      // at the value it will be sold for
+      if (ram_spent > 0) {
+         const asset liquid = eosio::token::get_balance("eosio.token"_n, self, EOS.code());
+         const asset pooled = eosiosystem::ram_quote(EOS).proceeds_minus_fee(state_value.ram_pooled());
+         check(liquid.amount + pooled.amount - state_value.owed_balances().amount - paid_out >= ram_spent,
+               "The contract does not hold enough unowed EOS to refill its RAM inventory.");
+         ram_spent = 0;
+      }
+      paid_out = 0;
+
+      if (state_changed) {
+         states.modify(state_itr, same_payer, [&](auto& row) { row = state_value; });
+         state_changed = false;
+      }
+   }
+
+private:
+   struct account_delta
+   {
+      name     owner;
+      uint64_t epoch;
+      int64_t  drops;
+   };
+
+   using account_iterator = drops::account_table::const_iterator;
+
+   [[maybe_unused]] memory_report                 report; // declared first so it reports after the rest is gone
+   name                                           self;
+   drops::state_table                             states;
+   drops::state_table::const_iterator             state_itr;
+   drops::state_row                               state_value;
+   bool                                           state_loaded  = false;
+   bool                                           state_changed = false;
+   int64_t                                        paid_out      = 0;
+   int64_t                                        ram_spent     = 0;
+   drops::account_table                           accounts;
+   std::vector<std::pair<name, account_iterator>> account_rows; // accounts looked up so far
+   std::vector<account_delta>                     deltas;       // sorted by owner and epoch
+
+   account_iterator find_account(name owner)
+   {
+      for (auto& [account, account_itr] : account_rows) {
+         if (account == owner) {
+            return account_itr;
+         }
+      }
+      account_rows.emplace_back(owner, accounts.find(owner.value));
+      return account_rows.back().second;
+   }
+
+   void cache_account(name owner, account_iterator account_itr)
+   {
+      for (auto& [account, cached_itr] : account_rows) {
+         if (account == owner) {
+            cached_itr = account_itr;
+         }
+      }
+   }
+};
+
 [[eosio::on_notify("eosio.token::transfer")]] drops::generate_return_value
 drops::generate(name from, name to, asset quantity, std::string memo)
 {
    if (from == "eosio.ram"_n || to != _self || from == _self || memo == "bypass") {
-      return {(uint32_t)0, (uint64_t)0, asset{0, EOS}, asset{0, EOS}, (uint64_t)0, (uint64_t)0};
+      return {(uint32_t)0, (uint64_t)0, asset{0, EOS}, asset{0, EOS}, (uint64_t)0, (uint64_t)0, (uint8_t)0, (uint32_t)0};
    }
 
    require_auth(from);
@@ -15,25 +260,29 @@ drops::generate(name from, name to, asset quantity, std::string memo)
    check(quantity.symbol == EOS, "Only the system token is accepted for transfers.");
    check(!memo.empty(), "A memo is required to send tokens to this contract");
 
-   // Process the memo field to determine the number of drops to generate
-   std::vector<std::string> parsed = split(memo, ',');
-   if (parsed[0] == "unbind") {
-      check(parsed.size() == 1, "Memo data must only contain 1 value of 'unbind'.");
-      return do_unbind(from, to, quantity, parsed);
-   } else {
-      check(parsed.size() == 2, "Memo data must contain 2 values, seperated by a "
-                                "comma using format: <drops_amount>,<drops_data>");
-      return do_generate(from, to, quantity, parsed);
+   // Process the memo field to determine the command to run
+   parsed_memo parsed = parse_memo(memo);
+   switch (parsed.command) {
+   case memo_command::unbind:
+      return do_unbind(from, to, quantity, parsed.data);
+   case memo_command::deposit:
+      return do_deposit(from, quantity);
+   case memo_command::generate:
+   default:
+      return do_generate(from, to, quantity, parsed.amount, parsed.data);
    }
 }
 
-drops::generate_return_value drops::do_generate(name from, name to, asset quantity, std::vector<std::string> parsed)
+drops::generate_return_value
+drops::do_generate(name from, name to, asset quantity, uint32_t amount, std::string_view data)
 {
    // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   uint64_t    epoch     = state_itr->epoch;
-   check(state_itr->enabled, "Contract is currently disabled.");
+   action_context ctx(_self);
+   const auto&    state      = ctx.state();
+   uint64_t       epoch      = state.epoch;
+   uint8_t        generation = state.generation_mode();
+   uint8_t        storage    = state.storage_mode();
+   check(state.enabled, "Contract is currently disabled.");
 
    epoch_table epochs(_self, _self.value);
    auto        epoch_itr = epochs.find(epoch);
@@ -42,178 +291,94 @@ drops::generate_return_value drops::do_generate(name from, name to, asset quanti
    time_point epoch_end = epoch_itr->end;
 
    // Ensure amount is a positive value
-   int amount = stoi(parsed[0]);
    check(amount > 0, "The amount of drops to generate must be a positive value.");
 
    // Ensure string length
-   string data = parsed[1];
    check(data.length() > 32, "Drop generation seed data must be at least 32 characters in length.");
 
-   // Calculate amount of RAM needing to be purchased
-   // NOTE: Additional RAM is being purchased to account for the buyrambytes bug
-   // SEE: https://github.com/EOSIO/eosio.system/issues/30
-   uint64_t ram_purchase_amount = amount * (record_size + purchase_buffer);
-
-   // Determine if this account exists in the accounts table
-   account_table accounts(_self, _self.value);
-   auto          account_itr        = accounts.find(from.value);
-   bool          account_row_exists = account_itr != accounts.end();
-
-   // First time accounts must purchase the extra ram to persist their stats in
-   // memory
-   if (!account_row_exists) {
-      ram_purchase_amount += accounts_row;
+   // Drops beyond the batch limit are queued in a mint job and created by resumemint
+   uint32_t      batch = std::min(amount, generate_batch_max);
+   mintjob_table mintjobs(_self, _self.value);
+   if (batch < amount) {
+      check(mintjobs.find(from.value) == mintjobs.end(), "Account already has a mint job in progress.");
    }
 
-   // Determine if this account exists in the epoch stats table
-   stat_table stats(_self, _self.value);
-   auto       stat_idx        = stats.get_index<"accountepoch"_n>();
-   auto       stat_itr        = stat_idx.find((uint128_t)from.value << 64 | epoch);
-   bool       stat_row_exists = stat_itr != stat_idx.end();
-
-   // First time epoch stats must purchase the extra ram to persist their stats
-   // in memory
-   if (!stat_row_exists) {
-      ram_purchase_amount += stats_row;
-   }
+   // Calculate amount of RAM needing to be purchased
+   uint64_t ram_purchase_amount = generate_ram(ctx, from, epoch, amount, data.length());
 
-   // Purchase the RAM for this transaction using the tokens from the transfer
-   action(permission_level{_self, "active"_n}, "eosio"_n, "buyrambytes"_n,
-          std::make_tuple(_self, _self, ram_purchase_amount))
-      .send();
+   // Take the RAM for this transaction from the inventory of the contract
+   asset ram_purchase_cost = allocate_ram(ctx, ram_purchase_amount);
+   check(quantity.amount >= ram_purchase_cost.amount,
+         "The amount sent does not cover the RAM purchase cost (requires " + ram_purchase_cost.to_string() + ")");
 
    // Iterate over all drops to be created and insert them into the drop table
-   drop_table drops(_self, _self.value);
-   for (int i = 0; i < amount; i++) {
-      string   value      = std::to_string(i) + data;
-      auto     hash       = sha256(value.c_str(), value.length());
-      auto     byte_array = hash.extract_as_byte_array();
-      uint64_t seed;
-      memcpy(&seed, &byte_array, sizeof(uint64_t));
-      drops.emplace(_self, [&](auto& row) {
-         row.seed    = seed;
-         row.owner   = from;
-         row.epoch   = epoch;
-         row.bound   = false;
-         row.created = current_time_point();
-      });
-   }
-
-   // Either update the account row or insert a new row
-   uint64_t new_drops_total = amount;
-   if (account_row_exists) {
-      new_drops_total += account_itr->drops;
-      accounts.modify(account_itr, _self, [&](auto& row) { row.drops = new_drops_total; });
-   } else {
-      accounts.emplace(_self, [&](auto& row) {
-         row.account = from;
-         row.drops   = new_drops_total;
-      });
-   }
-
-   // Either update the stats row or insert a new row
-   uint64_t new_drops_epoch = amount;
-   if (stat_row_exists) {
-      new_drops_epoch += stat_itr->drops;
-      stat_idx.modify(stat_itr, _self, [&](auto& row) { row.drops = new_drops_epoch; });
-   } else {
-      stats.emplace(_self, [&](auto& row) {
-         row.id      = stats.available_primary_key();
-         row.account = from;
-         row.drops   = new_drops_epoch;
-         row.epoch   = epoch;
+   seed_generator seeds(data, generation);
+   uint64_t       cursor     = 0;
+   uint32_t       collisions = emplace_drops(storage, seeds, cursor, batch, from, epoch, false, _self);
+
+   // Queue the remaining drops, the RAM for them has already been purchased
+   if (batch < amount) {
+      mintjobs.emplace(_self, [&](auto& row) {
+         row.owner      = from;
+         row.epoch      = epoch;
+         row.amount     = amount;
+         row.minted     = batch;
+         row.cursor     = cursor;
+         row.generation = generation;
+         row.bound      = false;
+         row.data       = std::string(data);
       });
    }
 
-   // Calculate the purchase cost via bancor after the purchase to ensure the
-   // incoming transfer can cover it
-   asset ram_purchase_cost = eosiosystem::ramcostwithfee(ram_purchase_amount, EOS);
-   check(quantity.amount >= ram_purchase_cost.amount,
-         "The amount sent does not cover the RAM purchase cost (requires " + ram_purchase_cost.to_string() + ")");
-
-   // Calculate any remaining tokens from the transfer after the RAM purchase
+   // Return any remaining tokens to the sender, a new balance row for them is
+   // paid for out of the remainder
+   ram_purchase_cost += credit_change(ctx, from, quantity - ram_purchase_cost);
    int64_t remainder = quantity.amount - ram_purchase_cost.amount;
 
-   // Return any remaining tokens to the sender
-   if (remainder > 0) {
-      action{permission_level{_self, "active"_n}, "eosio.token"_n, "transfer"_n,
-             std::tuple<name, name, asset, std::string>{_self, from, asset{remainder, EOS}, ""}}
-         .send();
-   }
+   // Update the account and stats rows
+   ctx.add_drops(from, epoch, batch);
+   ctx.flush(_self);
+   uint64_t new_drops_total = ctx.account(from)->drops;
+   uint64_t new_drops_epoch = ctx.account(from)->epoch_drops(epoch);
 
    return {
-      (uint32_t)amount,      // drops bought
+      batch,                 // drops bought
       epoch,                 // epoch
       ram_purchase_cost,     // cost
       asset{remainder, EOS}, // refund
       new_drops_total,       // total drops
       new_drops_epoch,       // epoch drops
+      generation,            // seed generation mode
+      collisions,            // seeds re-derived after a collision
    };
 }
 
-drops::generate_return_value drops::do_unbind(name from, name to, asset quantity, std::vector<std::string> parsed)
+drops::generate_return_value drops::do_unbind(name from, name to, asset quantity, std::string_view data)
 {
    // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   check(state_itr->enabled, "Contract is currently disabled.");
+   action_context ctx(_self);
+   uint8_t        storage = ctx.state().storage_mode();
+   check(ctx.state().enabled, "Contract is currently disabled.");
 
-   // Find the unbind request of the owner
-   unbind_table unbinds(_self, _self.value);
-   auto         unbinds_itr = unbinds.find(from.value);
-   check(unbinds_itr != unbinds.end(), "No unbind request found for account.");
+   // Drops listed in the memo are unbound directly, otherwise the next pages
+   // of the pending unbind request of the owner are completed
+   std::vector<uint64_t> drops_ids = data.empty() ? take_unbind_pages(from) : parse_drop_ids(data);
 
    // Calculate amount of RAM needing to be purchased
-   // NOTE: Additional RAM is being purchased to account for the buyrambytes bug
-   // SEE: https://github.com/EOSIO/eosio.system/issues/30
-   uint64_t ram_purchase_amount = unbinds_itr->drops_ids.size() * (record_size + purchase_buffer);
-
-   // Purchase the RAM for this transaction using the tokens from the transfer
-   action(permission_level{_self, "active"_n}, "eosio"_n, "buyrambytes"_n,
-          std::make_tuple(_self, _self, ram_purchase_amount))
-      .send();
-
-   // Iterate over all drops selected to be unbound
-   drops::drop_table drops(_self, _self.value);
-   for (auto it = begin(unbinds_itr->drops_ids); it != end(unbinds_itr->drops_ids); ++it) {
-      auto            drops_itr = drops.find(*it);
-      drops::drop_row drop      = *drops_itr;
-
-      check(drops_itr != drops.end(), "Drop " + std::to_string(drop.seed) + " not found");
-      check(drop.bound == true, "Drop " + std::to_string(drop.seed) + " is not bound.");
-      check(drop.owner == from, "Drop " + std::to_string(drop.seed) + " does not belong to account.");
-
-      // Destroy the row the contract was paying for
-      drops.erase(drops_itr);
-
-      // Recreate with owner as RAM payer and set as bound
-      drops.emplace(_self, [&](auto& row) {
-         row.seed    = drop.seed;
-         row.owner   = drop.owner;
-         row.epoch   = drop.epoch;
-         row.bound   = false;
-         row.created = drop.created;
-      });
-   }
+   uint64_t ram_purchase_amount = drops_ids.size() * drop_record_size(storage);
 
-   // Calculate the purchase cost via bancor after the purchase to ensure the
-   // incoming transfer can cover it
-   asset ram_purchase_cost = eosiosystem::ramcostwithfee(ram_purchase_amount, EOS);
+   // Take the RAM for this transaction from the inventory of the contract
+   asset ram_purchase_cost = allocate_ram(ctx, ram_purchase_amount);
    check(quantity.amount >= ram_purchase_cost.amount,
          "The amount sent does not cover the RAM purchase cost (requires " + ram_purchase_cost.to_string() + ")");
 
-   // Calculate any remaining tokens from the transfer after the RAM purchase
-   int64_t remainder = quantity.amount - ram_purchase_cost.amount;
-
-   // Return any remaining tokens to the sender
-   if (remainder > 0) {
-      action{permission_level{_self, "active"_n}, "eosio.token"_n, "transfer"_n,
-             std::tuple<name, name, asset, std::string>{_self, from, asset{remainder, EOS}, ""}}
-         .send();
-   }
+   unbind_drops(ctx, from, std::move(drops_ids));
 
-   // Destroy the unbind request now that its complete
-   unbinds.erase(unbinds_itr);
+   // Return any remaining tokens to the sender, a new balance row for them is
+   // paid for out of the remainder
+   ram_purchase_cost += credit_change(ctx, from, quantity - ram_purchase_cost);
+   int64_t remainder = quantity.amount - ram_purchase_cost.amount;
+   ctx.flush(_self);
 
    return {
       0,                     // drops bought
@@ -222,6 +387,165 @@ drops::generate_return_value drops::do_unbind(name from, name to, asset quantity
       asset{remainder, EOS}, // refund
       0,                     // total drops
       0,                     // epoch drops
+      0,                     // seed generation mode
+      0,                     // seeds re-derived after a collision
+   };
+}
+
+void drops::unbind_drops(action_context& ctx, name owner, std::vector<uint64_t> drops_ids)
+{
+   uint8_t storage = ctx.state().storage_mode();
+
+   // Iterate over all drops selected to be unbound, requests saved before ids
+   // were sorted are sorted here
+   seed_table seed_owners(_self, _self.value);
+   std::sort(drops_ids.begin(), drops_ids.end());
+
+   auto unbind = [&](auto& drops) {
+      for_each_drop(drops, drops_ids, [&](auto drops_itr) {
+         const uint64_t seed = drops_itr->seed;
+         check_drop(drops_itr->bound == true, drop_error::not_bound, seed);
+         check_drop(drops_itr->owner == owner, drop_error::not_owned, seed);
+
+         // Move the RAM from the owner to the contract and unbind in place
+         drops.modify(drops_itr, _self, [](auto& row) { row.bound = false; });
+
+         // The seed row or owner index entry is paid for by whoever pays for the drop
+         if (storage == storage_owner) {
+            seed_owners.modify(seed_owners.find(seed), _self, [](auto& row) {});
+            return ++drops_itr;
+         }
+         set_owner_index_payer(seed, _self);
+         return drops.end();
+      });
+   };
+
+   if (storage == storage_owner) {
+      owner_drop_table drops(_self, owner.value);
+      unbind(drops);
+   } else {
+      drop_table drops(_self, _self.value);
+      unbind(drops);
+   }
+}
+
+std::vector<uint64_t> drops::take_unbind_pages(name owner)
+{
+   // A request stored before paging is completed as a whole
+   unbind_table unbinds(_self, _self.value);
+   auto         unbinds_itr = unbinds.find(owner.value);
+   if (unbinds_itr != unbinds.end()) {
+      std::vector<uint64_t> drops_ids = unbinds_itr->drops_ids;
+      unbinds.erase(unbinds_itr);
+      return drops_ids;
+   }
+
+   // Pages are taken from the front, so the first remaining page is the cursor
+   // the next action resumes from
+   unbind_page_table pages(_self, owner.value);
+   auto              pages_itr = pages.begin();
+   check(pages_itr != pages.end(), "No unbind request found for account.");
+
+   std::vector<uint64_t> drops_ids;
+   for (uint32_t taken = 0; pages_itr != pages.end() && taken < unbind_pages_max; taken++) {
+      drops_ids.insert(drops_ids.end(), pages_itr->drops_ids.begin(), pages_itr->drops_ids.end());
+      pages_itr = pages.erase(pages_itr);
+   }
+   return drops_ids;
+}
+
+drops::generate_return_value drops::do_deposit(name from, asset quantity)
+{
+   // Retrieve contract state
+   action_context ctx(_self);
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   // A new balance row is paid for out of the deposit
+   asset row_cost{0, EOS};
+   if (!has_balance_row(from)) {
+      row_cost = allocate_ram(ctx, balances_row);
+      check(quantity.amount > row_cost.amount,
+            "The deposit does not cover the balance row (requires more than " + row_cost.to_string() + ")");
+   }
+
+   // Deposits are never paid back inline, they are kept until spent or claimed
+   balance_table balances(_self, _self.value);
+   auto          balance_itr = balances.find(from.value);
+   if (balance_itr == balances.end()) {
+      balances.emplace(_self, [&](auto& row) {
+         row.account = from;
+         row.balance = quantity - row_cost;
+         row.autopay = false;
+      });
+   } else {
+      balances.modify(balance_itr, same_payer, [&](auto& row) { row.balance += quantity; });
+   }
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.owed.emplace(row.owed_balances() + quantity - row_cost);
+   });
+   ctx.flush(_self);
+
+   return {
+      0,             // drops bought
+      0,             // epoch
+      row_cost,      // cost
+      asset{0, EOS}, // refund
+      0,             // total drops
+      0,             // epoch drops
+      0,             // seed generation mode
+      0,             // seeds re-derived after a collision
+   };
+}
+
+[[eosio::action]] drops::generate_return_value drops::gencredit(name owner, uint32_t amount, std::string data)
+{
+   require_auth(owner);
+
+   // Retrieve contract state
+   action_context ctx(_self);
+   const auto&    state      = ctx.state();
+   uint64_t       epoch      = state.epoch;
+   uint8_t        generation = state.generation_mode();
+   uint8_t        storage    = state.storage_mode();
+   check(state.enabled, "Contract is currently disabled.");
+
+   epoch_table epochs(_self, _self.value);
+   check(epochs.find(epoch) != epochs.end(), "Epoch does not exist.");
+
+   // Ensure amount is a positive value
+   check(amount > 0, "The amount of drops to generate must be a positive value.");
+   check(amount <= generate_batch_max,
+         "Cannot generate more than " + std::to_string(generate_batch_max) + " drops from credit at once.");
+
+   // Ensure string length
+   check(data.length() > 32, "Drop generation seed data must be at least 32 characters in length.");
+
+   // Price the RAM the drops and account row will use
+   uint64_t ram_amount = generate_ram(ctx, owner, epoch, amount, data.length());
+
+   asset ram_cost = allocate_ram(ctx, ram_amount);
+   debit(ctx, owner, ram_cost);
+
+   // Drops paid for from credit are unbound and held by the contract, the
+   // same as drops generated with a transfer
+   seed_generator seeds(data, generation);
+   uint64_t       cursor     = 0;
+   uint32_t       collisions = emplace_drops(storage, seeds, cursor, amount, owner, epoch, false, _self);
+
+   // Update the account row
+   ctx.add_drops(owner, epoch, amount);
+   ctx.flush(_self);
+
+   return {
+      amount,                                 // drops bought
+      epoch,                                  // epoch
+      ram_cost,                               // cost
+      asset{0, EOS},                          // refund
+      ctx.account(owner)->drops,              // total drops
+      ctx.account(owner)->epoch_drops(epoch), // epoch drops
+      generation,                             // seed generation mode
+      collisions,                             // seeds re-derived after a collision
    };
 }
 
@@ -230,10 +554,12 @@ drops::generate_return_value drops::do_unbind(name from, name to, asset quantity
    require_auth(owner);
 
    // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   uint64_t    epoch     = state_itr->epoch;
-   check(state_itr->enabled, "Contract is currently disabled.");
+   action_context ctx(_self);
+   const auto&    state      = ctx.state();
+   uint64_t       epoch      = state.epoch;
+   uint8_t        generation = state.generation_mode();
+   uint8_t        storage    = state.storage_mode();
+   check(state.enabled, "Contract is currently disabled.");
 
    epoch_table epochs(_self, _self.value);
    auto        epoch_itr = epochs.find(epoch);
@@ -247,306 +573,741 @@ drops::generate_return_value drops::do_unbind(name from, name to, asset quantity
    // Ensure string length
    check(data.length() > 32, "Drop data must be at least 32 characters in length.");
 
-   // Determine if this account exists in the accounts table
-   account_table accounts(_self, _self.value);
-   auto          account_itr        = accounts.find(owner.value);
-   bool          account_row_exists = account_itr != accounts.end();
-
-   // Determine if this account exists in the epoch stats table
-   stat_table stats(_self, _self.value);
-   auto       stat_idx        = stats.get_index<"accountepoch"_n>();
-   auto       stat_itr        = stat_idx.find((uint128_t)owner.value << 64 | epoch);
-   bool       stat_row_exists = stat_itr != stat_idx.end();
-
-   // Iterate over all drops to be created and insert them into the drops table
-   drop_table drops(_self, _self.value);
-   for (uint32_t i = 0; i < amount; i++) {
-      string   value      = std::to_string(i) + data;
-      auto     hash       = sha256(value.c_str(), value.length());
-      auto     byte_array = hash.extract_as_byte_array();
-      uint64_t seed;
-      memcpy(&seed, &byte_array, sizeof(uint64_t));
-      drops.emplace(owner, [&](auto& row) {
-         row.seed    = seed;
-         row.owner   = owner;
-         row.epoch   = epoch;
-         row.bound   = true;
-         row.created = current_time_point();
-      });
+   // Drops beyond the batch limit are queued in a mint job and created by resumemint
+   uint32_t      batch = std::min(amount, generate_batch_max);
+   mintjob_table mintjobs(_self, _self.value);
+   if (batch < amount) {
+      check(mintjobs.find(owner.value) == mintjobs.end(), "Account already has a mint job in progress.");
    }
 
-   // Either update the account row or insert a new row
-   uint64_t new_drops_total = amount;
-   if (account_row_exists) {
-      new_drops_total += account_itr->drops;
-      accounts.modify(account_itr, same_payer, [&](auto& row) { row.drops = new_drops_total; });
-   } else {
-      accounts.emplace(owner, [&](auto& row) {
-         row.account = owner;
-         row.drops   = new_drops_total;
+   // Iterate over all drops to be created and insert them into the drops table
+   seed_generator seeds(data, generation);
+   uint64_t       cursor     = 0;
+   uint32_t       collisions = emplace_drops(storage, seeds, cursor, batch, owner, epoch, true, owner);
+
+   // Queue the remaining drops
+   if (batch < amount) {
+      mintjobs.emplace(owner, [&](auto& row) {
+         row.owner      = owner;
+         row.epoch      = epoch;
+         row.amount     = amount;
+         row.minted     = batch;
+         row.cursor     = cursor;
+         row.generation = generation;
+         row.bound      = true;
+         row.data       = data;
       });
    }
 
-   // Either update the stats row or insert a new row
-   uint64_t new_drops_epoch = amount;
-   if (stat_row_exists) {
-      new_drops_epoch += stat_itr->drops;
-      stat_idx.modify(stat_itr, same_payer, [&](auto& row) { row.drops = new_drops_epoch; });
-   } else {
-      stats.emplace(owner, [&](auto& row) {
-         row.id      = stats.available_primary_key();
-         row.account = owner;
-         row.drops   = new_drops_epoch;
-         row.epoch   = epoch;
-      });
-   }
+   // Update the account and stats rows
+   ctx.add_drops(owner, epoch, batch);
+   ctx.flush(owner);
+   uint64_t new_drops_total = ctx.account(owner)->drops;
+   uint64_t new_drops_epoch = ctx.account(owner)->epoch_drops(epoch);
 
    return {
-      (uint32_t)amount, // drops bought
+      batch,            // drops bought
       epoch,            // epoch
       asset{0, EOS},    // cost
       asset{0, EOS},    // refund
       new_drops_total,  // total drops
       new_drops_epoch,  // epoch drops
+      generation,       // seed generation mode
+      collisions,       // seeds re-derived after a collision
+   };
+}
+
+[[eosio::action]] drops::generate_return_value drops::resumemint(name owner, uint32_t max)
+{
+   // Retrieve contract state
+   action_context ctx(_self);
+   uint8_t        storage = ctx.state().storage_mode();
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   check(max > 0, "The amount of drops to process must be a positive value.");
+
+   mintjob_table mintjobs(_self, _self.value);
+   auto          mintjob_itr = mintjobs.find(owner.value);
+   check(mintjob_itr != mintjobs.end(), "No mint job found for account.");
+
+   // Bound drops are paid for by the owner, unbound drops were already paid for
+   // when the job was created and can be processed by anyone
+   name ram_payer = _self;
+   if (mintjob_itr->bound) {
+      require_auth(owner);
+      ram_payer = owner;
+   }
+
+   uint32_t batch = std::min({max, generate_batch_max, mintjob_itr->amount - mintjob_itr->minted});
+
+   // Continue deriving seeds from where the previous batch stopped
+   seed_generator seeds(mintjob_itr->data, mintjob_itr->generation);
+   uint64_t       cursor = mintjob_itr->cursor;
+   uint32_t       collisions =
+      emplace_drops(storage, seeds, cursor, batch, owner, mintjob_itr->epoch, mintjob_itr->bound, ram_payer);
+
+   // Update the account and stats rows
+   uint64_t epoch      = mintjob_itr->epoch;
+   uint8_t  generation = mintjob_itr->generation;
+   ctx.add_drops(owner, epoch, batch);
+   ctx.flush(ram_payer);
+   uint64_t new_drops_total = ctx.account(owner)->drops;
+   uint64_t new_drops_epoch = ctx.account(owner)->epoch_drops(epoch);
+
+   // Advance the job, or remove it once every drop has been created
+   if (mintjob_itr->minted + batch == mintjob_itr->amount) {
+      mintjobs.erase(mintjob_itr);
+   } else {
+      mintjobs.modify(mintjob_itr, same_payer, [&](auto& row) {
+         row.minted += batch;
+         row.cursor = cursor;
+      });
+   }
+
+   return {
+      batch,           // drops bought
+      epoch,           // epoch
+      asset{0, EOS},   // cost
+      asset{0, EOS},   // refund
+      new_drops_total, // total drops
+      new_drops_epoch, // epoch drops
+      generation,      // seed generation mode
+      collisions,      // seeds re-derived after a collision
    };
 }
 
+[[eosio::action]] drops::mintmany_return_value
+drops::mintmany(name payer, std::vector<mint_recipient> recipients, std::string data)
+{
+   require_auth(payer);
+
+   // Retrieve contract state
+   action_context ctx(_self);
+   const auto&    state      = ctx.state();
+   uint64_t       epoch      = state.epoch;
+   uint8_t        generation = state.generation_mode();
+   uint8_t        storage    = state.storage_mode();
+   check(state.enabled, "Contract is currently disabled.");
+
+   epoch_table epochs(_self, _self.value);
+   check(epochs.find(epoch) != epochs.end(), "Epoch does not exist.");
+
+   check(recipients.size() > 0, "No recipients were provided to mint for.");
+
+   // Ensure string length
+   check(data.length() > 32, "Drop data must be at least 32 characters in length.");
+
+   // Every drop is created in this action, larger campaigns are split across
+   // several mintmany actions with different data
+   uint64_t amount = 0;
+   for (const auto& recipient : recipients) {
+      check(is_account(recipient.owner), "Account does not exist.");
+      check(recipient.amount > 0, "The amount of drops to generate must be a positive value.");
+      amount += recipient.amount;
+   }
+   check(amount <= generate_batch_max,
+         "Cannot mint more than " + std::to_string(generate_batch_max) + " drops in a single mintmany action.");
+
+   // The recipients share one seed generator, each continuing from the index
+   // where the previous one stopped. All drops are bound and their RAM, along
+   // with any new account rows or epoch entries, is billed to the payer, who
+   // gets it back when a recipient destroys or unbinds a drop. Recipients are
+   // not notified, a contract account among them could otherwise abort the
+   // whole batch or bill the payer for CPU in its notification handler.
+   seed_generator seeds(data, generation);
+   uint64_t       cursor     = 0;
+   uint32_t       collisions = 0;
+   for (const auto& recipient : recipients) {
+      collisions += emplace_drops(storage, seeds, cursor, recipient.amount, recipient.owner, epoch, true, payer);
+      ctx.add_drops(recipient.owner, epoch, recipient.amount);
+   }
+
+   // Update the account rows of every recipient
+   ctx.flush(payer);
+
+   return {
+      static_cast<uint32_t>(amount),            // drops minted
+      static_cast<uint32_t>(recipients.size()), // recipients
+      epoch,                                    // epoch
+      generation,                               // seed generation mode
+      collisions,                               // seeds re-derived after a collision
+   };
+}
+
+[[eosio::action]] asset drops::cancelmint(name owner)
+{
+   mintjob_table mintjobs(_self, _self.value);
+   auto          mintjob_itr = mintjobs.find(owner.value);
+   check(mintjob_itr != mintjobs.end(), "No mint job found for account.");
+
+   // Bound jobs can only be given up by the owner paying for them, unbound
+   // jobs may also be cleared by the contract
+   if (mintjob_itr->bound) {
+      require_auth(owner);
+   } else {
+      check(has_auth(owner) || has_auth(_self), "Missing required authority of the owner.");
+   }
+
+   // The RAM set aside for the drops an unbound job did not create goes back
+   // to the inventory and its value is credited to the owner
+   asset refund{0, EOS};
+   if (!mintjob_itr->bound) {
+      action_context ctx(_self);
+      uint64_t       ram_unused = (mintjob_itr->amount - mintjob_itr->minted) *
+                                drop_record_size(ctx.state().storage_mode()) +
+                             mintjobs_row + mintjob_itr->data.length();
+      refund = release_ram(ctx, ram_unused);
+      credit(ctx, owner, refund, _self, "Unused RAM value of a cancelled mint job");
+      ctx.flush(_self);
+   }
+
+   mintjobs.erase(mintjob_itr);
+   return refund;
+}
+
+uint32_t drops::emplace_drops(uint8_t         storage,
+                              seed_generator& seeds,
+                              uint64_t&       cursor,
+                              uint32_t        amount,
+                              name            owner,
+                              uint64_t        epoch,
+                              bool            bound,
+                              name            ram_payer)
+{
+   drop_writer writer(_self, storage, owner);
+   drop_row    drop;
+   drop.owner   = owner;
+   drop.epoch   = epoch;
+   drop.bound   = bound;
+   drop.created = current_time_point();
+
+   // Number of derived seeds that already existed and were skipped
+   uint32_t collisions = 0;
+
+   // Seeds are derived from consecutive indices starting at the cursor. When a
+   // seed already exists the index is skipped and the next one is used instead,
+   // so the resulting seeds remain deterministic and reproducible off-chain.
+   for (uint32_t created = 0; created < amount; cursor++) {
+      drop.seed = seeds.derive(cursor);
+      if (writer.exists(drop.seed)) {
+         collisions++;
+         continue;
+      }
+      writer.store(drop, ram_payer);
+      created++;
+   }
+   return collisions;
+}
+
+// RAM allocated to generate drops for an owner: the drops, the mint job holding
+// those beyond the batch limit, and the account row and scope table the drops
+// add. First time accounts pay for their account row, the first drops of an
+// epoch add an entry to it, and a row paid for by another account is taken
+// over by the contract, see action_context::account_ram.
+uint64_t drops::generate_ram(action_context& ctx, name owner, uint64_t epoch, uint32_t amount, size_t data_length)
+{
+   const uint8_t storage = ctx.state().storage_mode();
+   uint64_t      bytes   = amount * drop_record_size(storage);
+   if (amount > generate_batch_max) {
+      bytes += mintjobs_row + data_length;
+   }
+   return bytes + ctx.account_ram(owner, epoch, _self) + owner_scope_ram(storage, owner);
+}
+
+// RAM the first drop stored in the scope of an owner adds for its table, the
+// contract prices it when it pays for that drop
+uint64_t drops::owner_scope_ram(uint8_t storage, name owner)
+{
+   if (storage != storage_owner) {
+      return 0;
+   }
+   owner_drop_table owner_drops(_self, owner.value);
+   return owner_drops.begin() == owner_drops.end() ? owner_scope_table : 0;
+}
+
 [[eosio::action]] drops::generate_return_value drops::generatertrn() {}
 
 [[eosio::action]] void drops::transfer(name from, name to, std::vector<uint64_t> drops_ids, string memo)
 {
    require_auth(from);
 
+   action_context ctx(_self);
+   std::sort(drops_ids.begin(), drops_ids.end());
+   do_transfer(ctx, from, to, drops_ids);
+}
+
+[[eosio::action]] void drops::transferpack(name from, name to, std::vector<char> drops_ids, string memo)
+{
+   require_auth(from);
+
+   action_context ctx(_self);
+   do_transfer(ctx, from, to, packed_drop_ids(drops_ids));
+}
+
+[[eosio::action]] drops::selection_return_value
+drops::transfersel(name from, name to, drop_selector selector, string memo)
+{
+   require_auth(from);
+
+   action_context ctx(_self);
+
+   std::vector<uint64_t>  drops_ids;
+   selection_return_value selection = select_drops(ctx, from, selector, drops_ids);
+   if (!drops_ids.empty()) {
+      do_transfer(ctx, from, to, drops_ids);
+   }
+   return selection;
+}
+
+template <typename Ids> void drops::do_transfer(action_context& ctx, name from, name to, const Ids& drops_ids)
+{
    check(is_account(to), "Account does not exist.");
    check(drops_ids.size() > 0, "No drops were provided to transfer.");
 
    require_recipient(from);
    require_recipient(to);
 
+   // Retrieve contract state
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   transfer_drops(ctx, from, to, drops_ids);
+
+   // Write both account rows once, a first epoch entry for "to" is paid by
+   // "from", which takes over the row of "to" unless it already pays for it
+   ctx.flush(from);
+}
+
+[[eosio::action]] void drops::transfermany(name from, std::vector<transfer_group> groups, string memo)
+{
+   require_auth(from);
+
+   check(groups.size() > 0, "No recipients were provided to transfer to.");
+
+   action_context ctx(_self);
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   require_recipient(from);
+   for (auto& group : groups) {
+      check(is_account(group.to), "Account does not exist.");
+      check(group.drops_ids.size() > 0, "No drops were provided to transfer.");
+      require_recipient(group.to);
+
+      std::sort(group.drops_ids.begin(), group.drops_ids.end());
+      transfer_drops(ctx, from, group.to, group.drops_ids);
+   }
+
+   // The sender and every recipient are written once for the whole batch
+   ctx.flush(from);
+}
+
+template <typename Ids>
+void drops::transfer_drops(action_context& ctx, name from, name to, const Ids& drops_ids)
+{
+   // Rejected in both storage modes, in storage_owner a drop would be emplaced
+   // into the scope it is still stored in
+   check(from != to, "Cannot transfer to self.");
+
+   uint8_t storage = ctx.state().storage_mode();
+
+   // Iterate over all drops selected to be transferred
+   if (storage == storage_owner) {
+      // Drops move from the scope of the sender into the scope of the recipient.
+      // A first drop moved into an empty scope creates its table, which the
+      // contract absorbs unpriced, the same as the table of the sender it frees
+      // once the last drop leaves it.
+      owner_drop_table from_drops(_self, from.value);
+      owner_drop_table to_drops(_self, to.value);
+      seed_table       seed_owners(_self, _self.value);
+      for_each_drop(from_drops, drops_ids, [&](auto drops_itr) {
+         check_drop(drops_itr->bound == false, drop_error::bound_transfer, drops_itr->seed);
+         // Move the drop between the epoch totals of both accounts
+         ctx.add_drops(from, drops_itr->epoch, -1);
+         ctx.add_drops(to, drops_itr->epoch, 1);
+         // Perform the transfer
+         drops::drop_row drop = *drops_itr;
+         drop.owner           = to;
+         to_drops.emplace(_self, [&](auto& row) { row = drop; });
+         seed_owners.modify(seed_owners.find(drop.seed), same_payer, [&](auto& row) { row.owner = to; });
+         return from_drops.erase(drops_itr);
+      });
+   } else {
+      drops::drop_table drops(_self, _self.value);
+      for_each_drop(drops, drops_ids, [&](auto drops_itr) {
+         check_drop(drops_itr->bound == false, drop_error::bound_transfer, drops_itr->seed);
+         check_drop(drops_itr->owner == from, drop_error::not_owned_transfer, drops_itr->seed);
+         // Move the drop between the epoch totals of both accounts
+         ctx.add_drops(from, drops_itr->epoch, -1);
+         ctx.add_drops(to, drops_itr->epoch, 1);
+         // Perform the transfer
+         drops.modify(drops_itr, _self, [&](auto& row) { row.owner = to; });
+         return drops.end();
+      });
+   }
+}
+
+template <typename Ids>
+drops::bind_return_value drops::do_bind(action_context& ctx, name owner, const Ids& drops_ids)
+{
+   check(drops_ids.size() > 0, "No drops were provided to transfer.");
+
+   // Retrieve contract state
+   uint8_t storage = ctx.state().storage_mode();
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   // Iterate over all drops selected to be bound
+   seed_table seed_owners(_self, _self.value);
+
+   auto bind_drops = [&](auto& drops) {
+      for_each_drop(drops, drops_ids, [&](auto drops_itr) {
+         const uint64_t seed = drops_itr->seed;
+         check_drop(drops_itr->bound == false, drop_error::already_bound, seed);
+         check_drop(drops_itr->owner == owner, drop_error::not_owned, seed);
+
+         // Move the RAM from the contract to the owner and bind in place
+         drops.modify(drops_itr, owner, [](auto& row) { row.bound = true; });
+
+         // The seed row or owner index entry is paid for by whoever pays for the drop
+         if (storage == storage_owner) {
+            seed_owners.modify(seed_owners.find(seed), owner, [](auto& row) {});
+            return ++drops_itr;
+         }
+         set_owner_index_payer(seed, owner);
+         return drops.end();
+      });
+   };
+
+   if (storage == storage_owner) {
+      owner_drop_table drops(_self, owner.value);
+      bind_drops(drops);
+   } else {
+      drop_table drops(_self, _self.value);
+      bind_drops(drops);
+   }
+
+   // Calculate RAM sell amount and reclaim value
+   uint64_t ram_sell_amount   = drops_ids.size() * drop_record_size(storage);
+   asset    ram_sell_proceeds = eosiosystem::ram_quote(EOS).proceeds_minus_fee(ram_sell_amount);
+   if (ram_sell_amount > 0) {
+      // Owners paid inline need the RAM sold before the transfer is sent
+      pool_ram(ctx, ram_sell_amount, pays_inline(owner));
+      credit(ctx, owner, ram_sell_proceeds, owner,
+             "Reclaimed RAM value of " + std::to_string(drops_ids.size()) + " drops(s)");
+   }
+   ctx.flush(owner);
+
+   return {
+      ram_sell_amount,  // ram sold
+      ram_sell_proceeds // redeemed ram value
+   };
+}
+
+[[eosio::action]] void drops::unbind(name owner, std::vector<uint64_t> drops_ids)
+{
+   require_auth(owner);
+
+   check(drops_ids.size() > 0, "No drops were provided to transfer.");
+
    // Retrieve contract state
    state_table state(_self, _self.value);
    auto        state_itr = state.find(1);
    check(state_itr->enabled, "Contract is currently disabled.");
 
-   // Map to record which epochs drops were destroyed in for stat updates
-   map<uint64_t, uint64_t> epochs_transferred_in;
+   // Append to the unbind request and await for token transfer with matching
+   // memo data, topping up the last page before new pages are started
+   unbind_page_table pages(_self, owner.value);
+   auto              next = drops_ids.begin();
+   uint64_t          page = 0;
+   if (pages.begin() != pages.end()) {
+      auto last = --pages.end();
+      page      = last->page + 1;
+      if (last->drops_ids.size() < unbind_page_size) {
+         const size_t fill = std::min<size_t>(unbind_page_size - last->drops_ids.size(), drops_ids.end() - next);
+         pages.modify(last, owner, [&](auto& row) { row.drops_ids.insert(row.drops_ids.end(), next, next + fill); });
+         next += fill;
+      }
+   }
 
-   // Iterate over all drops selected to be transferred
-   drops::drop_table drops(_self, _self.value);
-   for (auto it = begin(drops_ids); it != end(drops_ids); ++it) {
-      auto drops_itr = drops.find(*it);
-      check(drops_itr != drops.end(), "Drop " + std::to_string(drops_itr->seed) + " not found");
-      check(drops_itr->bound == false,
-            "Drop " + std::to_string(drops_itr->seed) + " is bound and cannot be transferred");
-      check(drops_itr->owner == from, "Account does not own drop" + std::to_string(drops_itr->seed));
-      // Incremenent the values of all epochs we destroyed drops in
-      if (epochs_transferred_in.find(drops_itr->epoch) == epochs_transferred_in.end()) {
-         epochs_transferred_in[drops_itr->epoch] = 1;
-      } else {
-         epochs_transferred_in[drops_itr->epoch] += 1;
+   while (next != drops_ids.end()) {
+      const size_t fill = std::min<size_t>(unbind_page_size, drops_ids.end() - next);
+      pages.emplace(owner, [&](auto& row) {
+         row.page = page++;
+         row.drops_ids.assign(next, next + fill);
+      });
+      next += fill;
+   }
+}
+
+[[eosio::action]] void drops::unbindpack(name owner, std::vector<char> drops_ids)
+{
+   // The unbind request stores its ids as a list until the RAM payment arrives
+   packed_drop_ids ids(drops_ids);
+   unbind(owner, std::vector<uint64_t>(ids.begin(), ids.end()));
+}
+
+[[eosio::action]] void drops::cancelunbind(name owner)
+{
+   require_auth(owner);
+
+   // Retrieve contract state
+   state_table state(_self, _self.value);
+   auto        state_itr = state.find(1);
+   check(state_itr->enabled, "Contract is currently disabled.");
+
+   // Remove every page of the unbind request of the owner
+   unbind_table      unbinds(_self, _self.value);
+   unbind_page_table pages(_self, owner.value);
+   auto              unbinds_itr = unbinds.find(owner.value);
+   check(unbinds_itr != unbinds.end() || pages.begin() != pages.end(), "No unbind request found for account.");
+   if (unbinds_itr != unbinds.end()) {
+      unbinds.erase(unbinds_itr);
+   }
+   for (auto pages_itr = pages.begin(); pages_itr != pages.end();) {
+      pages_itr = pages.erase(pages_itr);
+   }
+}
+
+[[eosio::action]] drops::generate_return_value drops::unbindcredit(name owner)
+{
+   require_auth(owner);
+
+   // Retrieve contract state
+   action_context ctx(_self);
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   return unbind_from_credit(ctx, owner, take_unbind_pages(owner));
+}
+
+[[eosio::action]] drops::generate_return_value drops::unbindnow(name owner, std::vector<uint64_t> drops_ids)
+{
+   require_auth(owner);
+
+   check(drops_ids.size() > 0, "No drops were provided to unbind.");
+
+   // Retrieve contract state
+   action_context ctx(_self);
+   check(ctx.state().enabled, "Contract is currently disabled.");
+
+   // No unbind request is stored, a deposit earlier in the same transaction
+   // can fund the credit this draws from
+   return unbind_from_credit(ctx, owner, std::move(drops_ids));
+}
+
+drops::generate_return_value
+drops::unbind_from_credit(action_context& ctx, name owner, std::vector<uint64_t> drops_ids)
+{
+   // Pay for the RAM out of the credit of the owner
+   uint64_t ram_amount = drops_ids.size() * drop_record_size(ctx.state().storage_mode());
+   asset    ram_cost   = allocate_ram(ctx, ram_amount);
+   debit(ctx, owner, ram_cost);
+
+   unbind_drops(ctx, owner, std::move(drops_ids));
+   ctx.flush(_self);
+
+   return {
+      0,             // drops bought
+      0,             // epoch
+      ram_cost,      // cost
+      asset{0, EOS}, // refund
+      0,             // total drops
+      0,             // epoch drops
+      0,             // seed generation mode
+      0,             // seeds re-derived after a collision
+   };
+}
+
+[[eosio::action, eosio::read_only]] drops::account_stats_return_value drops::accountstats(name account)
+{
+   account_table              accounts(_self, _self.value);
+   auto                       account_itr = accounts.find(account.value);
+   account_stats_return_value stats{account, 0, {}};
+   if (account_itr != accounts.end()) {
+      stats.drops = account_itr->drops;
+      if (account_itr->epochs.has_value()) {
+         stats.epochs = account_itr->epochs.value();
       }
-      // Perform the transfer
-      drops.modify(drops_itr, _self, [&](auto& row) { row.owner = to; });
    }
+   return stats;
+}
 
-   // Decrement the account row for "from"
-   account_table accounts(_self, _self.value);
-   auto          account_from_itr = accounts.find(from.value);
-   check(account_from_itr != accounts.end(), "From account not found");
-   accounts.modify(account_from_itr, _self, [&](auto& row) { row.drops = row.drops - drops_ids.size(); });
-
-   // Increment the account row for "to"
-   auto account_to_itr = accounts.find(to.value);
-   if (account_to_itr != accounts.end()) {
-      accounts.modify(account_to_itr, _self, [&](auto& row) { row.drops = row.drops + drops_ids.size(); });
+[[eosio::action, eosio::read_only]] drops::generate_quote_return_value
+drops::genquote(name owner, uint32_t amount, uint32_t data_length)
+{
+   // The exact payment a generate of amount drops by owner needs in the current
+   // state, clients send it instead of pricing the rows themselves
+   action_context ctx(_self);
+   const uint64_t bytes = generate_ram(ctx, owner, ctx.state().epoch, amount, data_length);
+   return {bytes, quote_ram(ctx, bytes)};
+}
+
+[[eosio::action]] uint64_t drops::sellpool()
+{
+   // Anyone may sell the pooled RAM before the threshold is reached
+   action_context ctx(_self);
+   uint64_t       pooled = ctx.state().ram_pooled();
+   check(pooled > 0, "There is no pooled RAM to sell.");
+   pool_ram(ctx, 0, true);
+   ctx.flush(_self);
+   return pooled;
+}
+
+[[eosio::action]] uint64_t drops::refillram()
+{
+   // Anyone may top the inventory up ahead of the allocation that would
+   // otherwise run it low
+   action_context ctx(_self);
+   uint64_t       inventory = ctx.state().ram_available();
+   check(inventory < ram_inventory_refill / 2, "The RAM inventory does not need a refill.");
+   refill_ram(ctx, ram_inventory_refill - inventory);
+   ctx.flush(_self);
+   return ram_inventory_refill - inventory;
+}
+
+[[eosio::action]] asset drops::claim(name account)
+{
+   require_auth(account);
+
+   balance_table balances(_self, _self.value);
+   auto          balance_itr = balances.find(account.value);
+   check(balance_itr != balances.end() && balance_itr->balance.amount > 0, "Account has no balance to claim.");
+
+   const asset quantity = balance_itr->balance;
+
+   // Balances are partly credited at the quote of RAM still in the pool, it
+   // is sold before the transfer so its proceeds are there to pay out
+   action_context ctx(_self);
+   if (ctx.state().ram_pooled() > 0) {
+      pool_ram(ctx, 0, true);
+   }
+
+   // Rows are only kept around to remember autopay
+   if (balance_itr->autopay) {
+      balances.modify(balance_itr, same_payer, [&](auto& row) { row.balance.amount = 0; });
    } else {
-      accounts.emplace(from, [&](auto& row) {
-         row.account = to;
-         row.drops   = drops_ids.size();
-      });
+      balances.erase(balance_itr);
    }
 
-   // Iterate over map that recorded which epochs were transferred in
-   stat_table stats(_self, _self.value);
-   for (auto& iter : epochs_transferred_in) {
-      // Decrement the stat row for "from"
-      auto stat_from_idx = stats.get_index<"accountepoch"_n>();
-      auto stat_from_itr = stat_from_idx.find((uint128_t)from.value << 64 | iter.first);
-      stat_from_idx.modify(stat_from_itr, _self, [&](auto& row) { row.drops = row.drops - iter.second; });
-
-      // Increment the stat row for "to"
-      auto stat_to_idx     = stats.get_index<"accountepoch"_n>();
-      auto stat_to_itr     = stat_to_idx.find((uint128_t)to.value << 64 | iter.first);
-      bool stat_row_exists = stat_to_itr != stat_to_idx.end();
-      if (stat_row_exists) {
-         stat_to_idx.modify(stat_to_itr, _self, [&](auto& row) { row.drops = row.drops + iter.second; });
-      } else {
-         stats.emplace(from, [&](auto& row) {
-            row.id      = stats.available_primary_key();
-            row.account = to;
-            row.drops   = iter.second;
-            row.epoch   = iter.first;
+   token::transfer_action transfer_act{"eosio.token"_n, {{_self, "active"_n}}};
+   transfer_act.send(_self, account, quantity, "Claimed balance");
+   ctx.pay_out(quantity);
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.owed.emplace(row.owed_balances() - quantity);
+   });
+   ctx.flush(_self);
+
+   return quantity;
+}
+
+[[eosio::action]] void drops::setautopay(name account, bool autopay)
+{
+   require_auth(account);
+
+   balance_table balances(_self, _self.value);
+   auto          balance_itr = balances.find(account.value);
+   if (balance_itr == balances.end()) {
+      if (autopay) {
+         balances.emplace(account, [&](auto& row) {
+            row.account = account;
+            row.balance = asset{0, EOS};
+            row.autopay = true;
          });
       }
+   } else if (!autopay && balance_itr->balance.amount == 0) {
+      balances.erase(balance_itr);
+   } else {
+      balances.modify(balance_itr, same_payer, [&](auto& row) { row.autopay = autopay; });
    }
 }
 
-[[eosio::action]] drops::bind_return_value drops::bind(name owner, std::vector<uint64_t> drops_ids)
+[[eosio::action]] drops::destroy_return_value drops::destroy(name owner, std::vector<uint64_t> drops_ids, string memo)
 {
    require_auth(owner);
 
-   check(drops_ids.size() > 0, "No drops were provided to transfer.");
-
-   // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   check(state_itr->enabled, "Contract is currently disabled.");
-
-   // Iterate over all drops selected to be bound
-   drops::drop_table drops(_self, _self.value);
-   for (auto it = begin(drops_ids); it != end(drops_ids); ++it) {
-      auto            drops_itr = drops.find(*it);
-      drops::drop_row drop      = *drops_itr;
-
-      check(drops_itr != drops.end(), "Drop " + std::to_string(drop.seed) + " not found");
-      check(drop.bound == false, "Drop " + std::to_string(drop.seed) + " is already bound.");
-      check(drop.owner == owner, "Drop " + std::to_string(drop.seed) + " does not belong to account.");
-
-      // Destroy the row the contract was paying for
-      drops.erase(drops_itr);
-
-      // Recreate with owner as RAM payer and set as bound
-      drops.emplace(owner, [&](auto& row) {
-         row.seed    = drop.seed;
-         row.owner   = drop.owner;
-         row.epoch   = drop.epoch;
-         row.bound   = true;
-         row.created = drop.created;
-      });
-   }
-
-   // Calculate RAM sell amount and reclaim value
-   uint64_t ram_sell_amount   = drops_ids.size() * record_size;
-   asset    ram_sell_proceeds = eosiosystem::ramproceedstminusfee(ram_sell_amount, EOS);
-   if (ram_sell_amount > 0) {
-      action(permission_level{_self, "active"_n}, "eosio"_n, "sellram"_n, std::make_tuple(_self, ram_sell_amount))
-         .send();
-
-      token::transfer_action transfer_act{"eosio.token"_n, {{_self, "active"_n}}};
-      transfer_act.send(_self, owner, ram_sell_proceeds,
-                        "Reclaimed RAM value of " + std::to_string(drops_ids.size()) + " drops(s)");
-   }
-
-   return {
-      ram_sell_amount,  // ram sold
-      ram_sell_proceeds // redeemed ram value
-   };
+   action_context ctx(_self);
+   std::sort(drops_ids.begin(), drops_ids.end());
+   return do_destroy(ctx, owner, drops_ids);
 }
 
-[[eosio::action]] void drops::unbind(name owner, std::vector<uint64_t> drops_ids)
+[[eosio::action]] drops::destroy_return_value drops::destroypack(name owner, std::vector<char> drops_ids, string memo)
 {
    require_auth(owner);
 
-   check(drops_ids.size() > 0, "No drops were provided to transfer.");
-
-   // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   check(state_itr->enabled, "Contract is currently disabled.");
-
-   // Save the unbind request and await for token transfer with matching memo data
-   unbind_table unbinds(_self, _self.value);
-   unbinds.emplace(owner, [&](auto& row) {
-      row.owner     = owner;
-      row.drops_ids = drops_ids;
-   });
+   action_context ctx(_self);
+   return do_destroy(ctx, owner, packed_drop_ids(drops_ids));
 }
 
-[[eosio::action]] void drops::cancelunbind(name owner)
+[[eosio::action]] drops::selection_return_value drops::destroysel(name owner, drop_selector selector, string memo)
 {
    require_auth(owner);
 
-   // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   check(state_itr->enabled, "Contract is currently disabled.");
+   action_context ctx(_self);
 
-   // Remove the unbind request of the owner
-   unbind_table unbinds(_self, _self.value);
-   auto         unbinds_itr = unbinds.find(owner.value);
-   check(unbinds_itr != unbinds.end(), "No unbind request found for account.");
-   unbinds.erase(unbinds_itr);
+   std::vector<uint64_t>  drops_ids;
+   selection_return_value selection = select_drops(ctx, owner, selector, drops_ids);
+   if (!drops_ids.empty()) {
+      do_destroy(ctx, owner, drops_ids);
+   }
+   return selection;
 }
 
-[[eosio::action]] drops::destroy_return_value drops::destroy(name owner, std::vector<uint64_t> drops_ids, string memo)
+template <typename Ids>
+drops::destroy_return_value drops::do_destroy(action_context& ctx, name owner, const Ids& drops_ids)
 {
-   require_auth(owner);
-
    // Retrieve contract state
-   state_table state(_self, _self.value);
-   auto        state_itr = state.find(1);
-   check(state_itr->enabled, "Contract is currently disabled.");
+   uint8_t storage = ctx.state().storage_mode();
+   check(ctx.state().enabled, "Contract is currently disabled.");
 
    check(drops_ids.size() > 0, "No drops were provided to destroy.");
    //    check(drops_ids.size() <= 5000, "Cannot destroy more than 5000 at a
    //    time.");
 
-   drops::drop_table drops(_self, _self.value);
-
-   // Map to record which epochs drops were destroyed in
-   map<uint64_t, uint64_t> epochs_destroyed_in;
+   seed_table seed_owners(_self, _self.value);
 
    // The number of bound drops that were destroyed
    int bound_destroyed = 0;
 
    // Loop to destroy specified drops
-   for (auto it = begin(drops_ids); it != end(drops_ids); ++it) {
-      auto drops_itr = drops.find(*it);
-      check(drops_itr != drops.end(), "Drop not found");
-      check(drops_itr->owner == owner, "Account does not own this drops");
-      // Incremenent the values of all epochs we destroyed drops in
-      if (epochs_destroyed_in.find(drops_itr->epoch) == epochs_destroyed_in.end()) {
-         epochs_destroyed_in[drops_itr->epoch] = 1;
-      } else {
-         epochs_destroyed_in[drops_itr->epoch] += 1;
-      }
-      // Destroy the drops
-      drops.erase(drops_itr);
-      // Count the number of bound drops destroyed
-      // This will be subtracted from the amount paid out
-      if (drops_itr->bound) {
-         bound_destroyed++;
-      }
-   }
+   auto destroy_drops = [&](auto& drops) {
+      for_each_drop(drops, drops_ids, [&](auto drops_itr) {
+         check(drops_itr->owner == owner, "Account does not own this drops");
+         // Decrement the epoch total the drop was counted in
+         ctx.add_drops(owner, drops_itr->epoch, -1);
+         // Count the number of bound drops destroyed
+         // This will be subtracted from the amount paid out
+         if (drops_itr->bound) {
+            bound_destroyed++;
+         }
+         // Destroy the drops
+         if (storage == storage_owner) {
+            seed_owners.erase(seed_owners.find(drops_itr->seed));
+         }
+         return drops.erase(drops_itr);
+      });
+   };
 
-   // Iterate over map that recorded which epochs were destroyed in, decrement
-   // table values
-   for (auto& iter : epochs_destroyed_in) {
-      stat_table stats(_self, _self.value);
-      auto       stat_idx = stats.get_index<"accountepoch"_n>();
-      auto       stat_itr = stat_idx.find((uint128_t)owner.value << 64 | iter.first);
-      stat_idx.modify(stat_itr, _self, [&](auto& row) { row.drops = row.drops - iter.second; });
+   if (storage == storage_owner) {
+      owner_drop_table drops(_self, owner.value);
+      destroy_drops(drops);
+   } else {
+      drop_table drops(_self, _self.value);
+      destroy_drops(drops);
    }
 
-   // Decrement the account row
-   account_table accounts(_self, _self.value);
-   auto          account_itr = accounts.find(owner.value);
-   accounts.modify(account_itr, _self, [&](auto& row) { row.drops = row.drops - drops_ids.size(); });
-
    // Calculate RAM sell amount and proceeds
-   uint64_t ram_sell_amount   = (drops_ids.size() - bound_destroyed) * record_size;
-   asset    ram_sell_proceeds = eosiosystem::ramproceedstminusfee(ram_sell_amount, EOS);
+   uint64_t ram_sell_amount   = (drops_ids.size() - bound_destroyed) * drop_record_size(storage);
+   asset    ram_sell_proceeds = eosiosystem::ram_quote(EOS).proceeds_minus_fee(ram_sell_amount);
    if (ram_sell_amount > 0) {
-      action(permission_level{_self, "active"_n}, "eosio"_n, "sellram"_n, std::make_tuple(_self, ram_sell_amount))
-         .send();
-
-      token::transfer_action transfer_act{"eosio.token"_n, {{_self, "active"_n}}};
-      transfer_act.send(_self, owner, ram_sell_proceeds,
-                        "Reclaimed RAM value of " + std::to_string(drops_ids.size()) + " drops(s)");
+      // Owners paid inline need the RAM sold before the transfer is sent
+      pool_ram(ctx, ram_sell_amount, pays_inline(owner));
+      credit(ctx, owner, ram_sell_proceeds, owner,
+             "Reclaimed RAM value of " + std::to_string(drops_ids.size()) + " drops(s)");
    }
 
+   // Write the account row and state once, rows only shrink here so the payer is unchanged
+   ctx.flush(owner);
+
    // Calculate how much of their own RAM the account reclaimed
-   uint64_t ram_reclaimed = bound_destroyed * record_size;
+   uint64_t ram_reclaimed = bound_destroyed * drop_record_size(storage);
 
    return {
       ram_sell_amount,   // ram sold
@@ -555,6 +1316,47 @@ drops::generate_return_value drops::do_unbind(name from, name to, asset quantity
    };
 }
 
+drops::selection_return_value
+drops::select_drops(action_context& ctx, name owner, const drop_selector& selector, std::vector<uint64_t>& drops_ids)
+{
+   check(selector.limit > 0, "The selector limit must be a positive value.");
+   check(selector.epoch_start <= selector.epoch_end, "The selector epoch range is empty.");
+
+   uint8_t storage = ctx.state().storage_mode();
+
+   // Walk the drops of the owner in seed order, stopping once the limit is
+   // reached or the scan budget for this action is spent
+   auto select = [&](auto itr, auto end) -> selection_return_value {
+      uint32_t scanned = 0;
+      for (; itr != end && scanned < select_scan_max && drops_ids.size() < selector.limit; ++itr, ++scanned) {
+         if (itr->bound == selector.bound && itr->epoch >= selector.epoch_start && itr->epoch <= selector.epoch_end) {
+            drops_ids.push_back(itr->seed);
+         }
+      }
+      if (itr == end) {
+         return {static_cast<uint32_t>(drops_ids.size()), 0, true};
+      }
+      return {static_cast<uint32_t>(drops_ids.size()), itr->seed, false};
+   };
+
+   if (storage == storage_owner) {
+      owner_drop_table drops(_self, owner.value);
+      return select(drops.lower_bound(selector.cursor), drops.end());
+   }
+
+   // Entries of the owner index are ordered by seed within each owner. The
+   // cursor is only followed while it still points at a drop of this owner,
+   // otherwise the walk restarts at the first drop of the owner.
+   drop_table drops(_self, _self.value);
+   auto       owner_idx  = drops.get_index<"owner"_n>();
+   auto       itr        = owner_idx.lower_bound(owner.value);
+   auto       cursor_itr = drops.find(selector.cursor);
+   if (cursor_itr != drops.end() && cursor_itr->owner == owner) {
+      itr = owner_idx.iterator_to(*cursor_itr);
+   }
+   return select(itr, owner_idx.upper_bound(owner.value));
+}
+
 drops::epoch_row drops::advance_epoch()
 {
    // Retrieve contract state
@@ -613,8 +1415,15 @@ drops::epoch_row drops::advance_epoch()
 {
    require_auth(_self);
 
-   uint64_t            drops_destroyed = 0;
-   map<name, uint64_t> drops_destroyed_for;
+   drops::state_table state(_self, _self.value);
+   auto               state_itr = state.find(1);
+   uint8_t            storage   = state_itr->storage_mode();
+
+   [[maybe_unused]] memory_report report;
+   scratch_scope scratch;
+
+   uint64_t                    drops_destroyed = 0;
+   scratch_map<name, uint64_t> drops_destroyed_for;
 
    drops::drop_table drops(_self, _self.value);
    auto              drops_itr = drops.begin();
@@ -629,6 +1438,17 @@ drops::epoch_row drops::advance_epoch()
       drops_itr = drops.erase(drops_itr);
    }
 
+   // Drops stored in owner scopes are found through the seed table
+   drops::seed_table seed_owners(_self, _self.value);
+   auto              seed_itr = seed_owners.begin();
+   while (seed_itr != seed_owners.end()) {
+      drops_destroyed += 1;
+      drops_destroyed_for[seed_itr->owner] += 1;
+      drops::owner_drop_table owner_drops(_self, seed_itr->owner.value);
+      owner_drops.erase(owner_drops.find(seed_itr->seed));
+      seed_itr = seed_owners.erase(seed_itr);
+   }
+
    drops::account_table accounts(_self, _self.value);
    auto                 account_itr = accounts.begin();
    while (account_itr != accounts.end()) {
@@ -642,12 +1462,13 @@ drops::epoch_row drops::advance_epoch()
    }
 
    // Calculate RAM sell amount
-   uint64_t ram_to_sell = drops_destroyed * record_size;
+   uint64_t ram_to_sell = drops_destroyed * drop_record_size(storage);
    action(permission_level{_self, "active"_n}, "eosio"_n, "sellram"_n, std::make_tuple(_self, ram_to_sell)).send();
 
+   eosiosystem::ram_quote ram_quote(EOS);
    for (auto& iter : drops_destroyed_for) {
-      uint64_t ram_sell_amount   = iter.second * record_size;
-      asset    ram_sell_proceeds = eosiosystem::ramproceedstminusfee(ram_sell_amount, EOS);
+      uint64_t ram_sell_amount   = iter.second * drop_record_size(storage);
+      asset    ram_sell_proceeds = ram_quote.proceeds_minus_fee(ram_sell_amount);
 
       token::transfer_action transfer_act{"eosio.token"_n, {{_self, "active"_n}}};
       //    check(false, "ram_sell_proceeds: " + ram_sell_proceeds.to_string());
@@ -662,6 +1483,16 @@ drops::epoch_row drops::advance_epoch()
 
    drops::state_table state(_self, _self.value);
    auto               state_itr = state.find(1);
+
+   // Stats are only read from the account rows and drops only in the v2
+   // layout, both migrations must have completed first
+   if (enabled) {
+      drops::stat_table stats(_self, _self.value);
+      check(stats.begin() == stats.end(), "Stats must be migrated with migratestats before enabling.");
+      check(state_itr->drop_layout_version() == drop_layout_v2,
+            "Drops must be migrated with migratedrops before enabling.");
+   }
+
    state.modify(state_itr, _self, [&](auto& row) { row.enabled = enabled; });
 }
 
@@ -671,9 +1502,8 @@ drops::epoch_row drops::advance_epoch()
 
    account_table accounts(_self, _self.value);
    epoch_table   epochs(_self, _self.value);
-   drop_table    drops(_self, _self.value);
    state_table   state(_self, _self.value);
-   stat_table    stats(_self, _self.value);
+   drop_writer   drops(_self, storage_global, _self);
 
    // Round epoch timer down to nearest interval to start with
    const time_point_sec epoch =
@@ -687,45 +1517,23 @@ drops::epoch_row drops::advance_epoch()
    });
 
    // Give system contract the 0 drops
-   drops.emplace(_self, [&](auto& row) {
-      row.seed    = 0;
-      row.owner   = "eosio"_n;
-      row.epoch   = 1;
-      row.bound   = true;
-      row.created = epoch;
-   });
+   drops.store({0, 1, "eosio"_n, epoch, true}, _self);
 
    accounts.emplace(_self, [&](auto& row) {
       row.account = "eosio"_n;
-      row.drops   = 1;
-   });
-
-   stats.emplace(_self, [&](auto& row) {
-      row.id      = 1;
-      row.account = "eosio"_n;
-      row.epoch   = 1;
-      row.drops   = 1;
+      row.drops   = 0;
+      row.add_drops(1, 1);
+      row.set_payer(_self);
    });
 
    // Give Greymass the "Greymass" drops
-   drops.emplace(_self, [&](auto& row) {
-      row.seed    = 7338027470446133248;
-      row.owner   = "teamgreymass"_n;
-      row.epoch   = 1;
-      row.bound   = true;
-      row.created = epoch;
-   });
+   drops.store({greymass_seed, 1, "teamgreymass"_n, epoch, true}, _self);
 
    accounts.emplace(_self, [&](auto& row) {
       row.account = "teamgreymass"_n;
-      row.drops   = 1;
-   });
-
-   stats.emplace(_self, [&](auto& row) {
-      row.id      = 2;
-      row.account = "teamgreymass"_n;
-      row.epoch   = 1;
-      row.drops   = 1;
+      row.drops   = 0;
+      row.add_drops(1, 1);
+      row.set_payer(_self);
    });
 
    // Set the current state to epoch 1
@@ -733,16 +1541,444 @@ drops::epoch_row drops::advance_epoch()
       row.id      = 1;
       row.epoch   = 1;
       row.enabled = false;
+      row.generation.emplace(generation_v1);
+      row.extend();
+      row.drop_layout.emplace(drop_layout_v2);
+   });
+}
+
+[[eosio::action]] void drops::setgenmode(uint8_t generation)
+{
+   require_auth(_self);
+
+   check(generation == generation_v1 || generation == generation_v2, "Unknown seed generation mode.");
+
+   drops::state_table state(_self, _self.value);
+   auto               state_itr = state.find(1);
+   check(state_itr != state.end(), "Contract state does not exist.");
+   state.modify(state_itr, _self, [&](auto& row) { row.generation.emplace(generation); });
+}
+
+[[eosio::action]] void drops::reconcileram(uint64_t unused_bytes)
+{
+   require_auth(_self);
+
+   // get_resource_limits is privileged, so the unused bytes of the contract
+   // (quota minus usage) are supplied here and checked against the quota the
+   // system contract recorded
+   eosiosystem::user_resources_table resources("eosio"_n, _self.value);
+   auto                              resources_itr = resources.find(_self.value);
+   check(resources_itr != resources.end(), "Contract has no RAM quota.");
+   check(unused_bytes <= uint64_t(resources_itr->ram_bytes), "Unused RAM cannot exceed the RAM quota of the contract.");
+
+   // Pooled bytes are unused too, but are already promised to the RAM market
+   action_context ctx(_self);
+   const uint64_t pooled = ctx.state().ram_pooled();
+   const asset    price  = eosiosystem::ram_quote(EOS).cost_with_fee(ram_inventory_refill);
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.ram_inventory.emplace(unused_bytes > pooled ? unused_bytes - pooled : 0);
+      row.ram_price.emplace(price);
+   });
+   ctx.flush(_self);
+}
+
+[[eosio::action]] void drops::setstorage(uint8_t storage)
+{
+   require_auth(_self);
+
+   check(storage == storage_global || storage == storage_owner, "Unknown drop storage mode.");
+
+   drops::state_table state(_self, _self.value);
+   auto               state_itr = state.find(1);
+   check(state_itr != state.end(), "Contract state does not exist.");
+   check(!state_itr->enabled, "Contract must be disabled to change the drop storage mode.");
+   if (state_itr->storage_mode() == storage) {
+      return;
+   }
+
+   // Move the drops given out by init into the new storage, any other drop
+   // means the storage mode can no longer be changed
+   const auto check_movable = [](uint64_t seed) {
+      check(seed == 0 || seed == greymass_seed, "The drop storage mode can only be changed before drops are generated.");
+   };
+
+   drops::drop_table drops(_self, _self.value);
+   drops::seed_table seed_owners(_self, _self.value);
+   if (storage == storage_owner) {
+      auto drops_itr = drops.begin();
+      while (drops_itr != drops.end()) {
+         check_movable(drops_itr->seed);
+         drops::drop_row         drop = *drops_itr;
+         drops::owner_drop_table owner_drops(_self, drop.owner.value);
+         owner_drops.emplace(_self, [&](auto& row) { row = drop; });
+         seed_owners.emplace(_self, [&](auto& row) {
+            row.seed  = drop.seed;
+            row.owner = drop.owner;
+         });
+         drops_itr = drops.erase(drops_itr);
+      }
+   } else {
+      auto seed_itr = seed_owners.begin();
+      while (seed_itr != seed_owners.end()) {
+         check_movable(seed_itr->seed);
+         drops::owner_drop_table owner_drops(_self, seed_itr->owner.value);
+         auto                    owner_drops_itr = owner_drops.find(seed_itr->seed);
+         drops::drop_row         drop            = *owner_drops_itr;
+         drops.emplace(_self, [&](auto& row) { row = drop; });
+         owner_drops.erase(owner_drops_itr);
+         seed_itr = seed_owners.erase(seed_itr);
+      }
+   }
+
+   state.modify(state_itr, _self, [&](auto& row) {
+      row.generation.emplace(row.generation_mode());
+      row.storage.emplace(storage);
+   });
+}
+
+[[eosio::action]] drops::migrate_return_value drops::migratedrops(uint64_t start, uint32_t max)
+{
+   require_auth(_self);
+
+   // Rows are rewritten outside of multi_index, nothing else may modify the
+   // table until the migration has completed
+   state_table state(_self, _self.value);
+   auto        state_itr = state.find(1);
+   check(!state_itr->enabled, "Contract must be disabled while migrating drops.");
+   check(max > 0, "The amount of drops to migrate must be a positive value.");
+
+   using namespace eosio::internal_use_do_not_use;
+   const uint64_t code  = _self.value;
+   const uint64_t scope = _self.value;
+   const uint64_t table = "drop"_n.value;
+   // multi_index stores secondary index 0 of a table under this name
+   const uint64_t owner_index = table & 0xFFFFFFFFFFFFFFF0ULL;
+
+   uint32_t migrated = 0;
+   uint32_t scanned  = 0;
+   uint64_t next     = start;
+   int32_t  itr      = db_lowerbound_i64(code, scope, table, start);
+   char     buffer[drop_v1_size];
+   while (itr >= 0 && scanned < max) {
+      const int32_t size     = db_get_i64(itr, buffer, sizeof(buffer));
+      const int32_t next_itr = db_next_i64(itr, &next);
+
+      if (size == drop_v1_size) {
+         drop_row drop = unpack<drop_row>(buffer, size);
+
+         // Remove the v1 128-bit owner index entry
+         uint128_t     owner_key_v1;
+         const int32_t owner_v1_itr = db_idx128_find_primary(code, scope, owner_index, &owner_key_v1, drop.seed);
+         if (owner_v1_itr >= 0) {
+            db_idx128_remove(owner_v1_itr);
+         }
+
+         // Rewrite the row in place using the v2 layout, keeping its payer
+         const std::vector<char> packed = pack(drop);
+         db_update_i64(itr, 0, packed.data(), packed.size());
+
+         // Store the v2 64-bit owner index entry
+         const uint64_t owner_key = drop.by_owner();
+         db_idx64_store(scope, owner_index, drop_payer(drop).value, drop.seed, &owner_key);
+
+         migrated++;
+      }
+
+      scanned++;
+      itr = next_itr;
+   }
+
+   // Record that no v1 rows are left once the scan reaches the end of the table
+   if (itr < 0) {
+      state.modify(state_itr, same_payer, [&](auto& row) {
+         row.extend();
+         row.drop_layout.emplace(drop_layout_v2);
+      });
+   }
+
+   return {
+      migrated, // rows rewritten
+      next,     // seed to resume from
+      itr < 0   // completed
+   };
+}
+
+[[eosio::action]] drops::migrate_return_value drops::migratestats(uint32_t max)
+{
+   require_auth(_self);
+
+   drops::state_table state(_self, _self.value);
+   auto               state_itr = state.find(1);
+   check(!state_itr->enabled, "Contract must be disabled to migrate stats.");
+
+   check(max > 0, "The amount of rows to migrate must be a positive value.");
+
+   // Merge each stat row into the epoch breakdown of its account row, the
+   // contract takes over the RAM of the merged rows
+   drops::account_table accounts(_self, _self.value);
+   drops::stat_table    stats(_self, _self.value);
+   auto                 stats_itr = stats.begin();
+   uint32_t             migrated  = 0;
+   while (stats_itr != stats.end() && migrated < max) {
+      if (stats_itr->drops > 0) {
+         auto account_itr = accounts.find(stats_itr->account.value);
+         if (account_itr == accounts.end()) {
+            accounts.emplace(_self, [&](auto& row) {
+               row.account = stats_itr->account;
+               row.drops   = 0;
+               row.add_drops(stats_itr->epoch, stats_itr->drops);
+               row.set_payer(_self);
+            });
+         } else {
+            // The lifetime total already counts these drops
+            accounts.modify(account_itr, _self, [&](auto& row) {
+               row.add_drops(stats_itr->epoch, stats_itr->drops);
+               row.drops -= stats_itr->drops;
+               row.set_payer(_self);
+            });
+         }
+      }
+      stats_itr = stats.erase(stats_itr);
+      migrated++;
+   }
+
+   return {
+      migrated,                                                // rows merged
+      stats_itr != stats.end() ? stats_itr->primary_key() : 0, // stat row to resume from
+      stats_itr == stats.end()                                 // completed
+   };
+}
+
+void drops::set_owner_index_payer(uint64_t seed, name payer)
+{
+   // multi_index::modify only rewrites a secondary index entry when its key
+   // changes, so a new payer has to be applied to the owner index separately
+   using namespace eosio::internal_use_do_not_use;
+   const uint64_t owner_index = "drop"_n.value & 0xFFFFFFFFFFFFFFF0ULL;
+   uint64_t       owner_key;
+   const int32_t  owner_itr = db_idx64_find_primary(_self.value, _self.value, owner_index, &owner_key, seed);
+   check_drop(owner_itr >= 0, drop_error::no_owner_index, seed);
+   db_idx64_update(owner_itr, payer.value, &owner_key);
+}
+
+void drops::pool_ram(action_context& ctx, uint64_t bytes, bool sell_now)
+{
+   // Owners are credited at the quote of the action that freed the RAM, the
+   // contract sells the pool later in a single sellram
+   uint64_t pooled = ctx.state().ram_pooled() + bytes;
+   if (pooled > 0 && (sell_now || pooled >= ram_pool_threshold)) {
+      action(permission_level{_self, "active"_n}, "eosio"_n, "sellram"_n, std::make_tuple(_self, pooled)).send();
+      pooled = 0;
+   }
+
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.ram_pool.emplace(pooled);
+   });
+}
+
+bool drops::has_balance_row(name account)
+{
+   balance_table balances(_self, _self.value);
+   return balances.find(account.value) != balances.end();
+}
+
+bool drops::pays_inline(name account)
+{
+   balance_table balances(_self, _self.value);
+   auto          balance_itr = balances.find(account.value);
+   return balance_itr != balances.end() && balance_itr->autopay;
+}
+
+void drops::debit(action_context& ctx, name account, asset quantity)
+{
+   balance_table balances(_self, _self.value);
+   auto          balance_itr = balances.find(account.value);
+   check(balance_itr != balances.end() && balance_itr->balance.amount >= quantity.amount,
+         "The RAM credit of the account does not cover the cost (requires " + quantity.to_string() + ")");
+   balances.modify(balance_itr, same_payer, [&](auto& row) { row.balance -= quantity; });
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.owed.emplace(row.owed_balances() - quantity);
+   });
+}
+
+asset drops::allocate_ram(action_context& ctx, uint64_t bytes)
+{
+   // Until reconcileram records the inventory, as after an upgrade or init,
+   // every allocation buys its own RAM out of the payment it is charged
+   if (!ctx.state().ram_inventory_ready()) {
+      return buy_ram(ctx, bytes);
+   }
+
+   // New rows use RAM the contract already holds, priced at the quote of the
+   // last bulk purchase. More is bought only when the inventory would run
+   // below the low mark.
+   const uint64_t needed = bytes + ram_inventory_low;
+   if (ctx.state().ram_available() < needed) {
+      refill_ram(ctx, std::max(ram_inventory_refill, needed - ctx.state().ram_available()));
+   }
+
+   const uint64_t inventory = ctx.state().ram_available();
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.ram_inventory.emplace(inventory - bytes);
+   });
+   return price_ram(ctx, bytes);
+}
+
+asset drops::price_ram(action_context& ctx, uint64_t bytes)
+{
+   return price_allocation(ctx.state().ram_price.value(), bytes);
+}
+
+asset drops::quote_ram(action_context& ctx, uint64_t bytes)
+{
+   // What allocate_ram would charge, a refill it would make reprices the
+   // inventory at the current market
+   const eosiosystem::ram_quote quote(EOS);
+   if (!ctx.state().ram_inventory_ready()) {
+      return quote.cost_with_fee(bytes + purchase_buffer);
+   }
+   if (ctx.state().ram_available() < bytes + ram_inventory_low) {
+      return price_allocation(quote.cost_with_fee(ram_inventory_refill), bytes);
+   }
+   return price_ram(ctx, bytes);
+}
+
+asset drops::release_ram(action_context& ctx, uint64_t bytes)
+{
+   // Without an inventory the bytes were bought for the allocation itself, they
+   // are pooled for sale and worth what the sale will return
+   if (!ctx.state().ram_inventory_ready()) {
+      pool_ram(ctx, bytes, false);
+      return eosiosystem::ram_quote(EOS).proceeds_minus_fee(bytes);
+   }
+
+   // Rounded down, released RAM is never worth more than it was sold for
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.ram_inventory.emplace(row.ram_available() + bytes);
+   });
+   return asset{int64_t(uint128_t(ctx.state().ram_price.value().amount) * bytes / ram_inventory_refill), EOS};
+}
+
+asset drops::buy_ram(action_context& ctx, uint64_t bytes)
+{
+   // NOTE: Additional RAM is being purchased to account for the buyrambytes bug
+   // SEE: https://github.com/EOSIO/eosio.system/issues/30
+   action(permission_level{_self, "active"_n}, "eosio"_n, "buyrambytes"_n,
+          std::make_tuple(_self, _self, bytes + purchase_buffer))
+      .send();
+
+   // Inline actions run after this one, so the quote is taken from the same
+   // market state the buyrambytes action will see. flush checks the purchase
+   // is covered by EOS no balance row is owed.
+   const asset cost = eosiosystem::ram_quote(EOS).cost_with_fee(bytes + purchase_buffer);
+   ctx.spend_on_ram(cost);
+   return cost;
+}
+
+void drops::refill_ram(action_context& ctx, uint64_t bytes)
+{
+   buy_ram(ctx, bytes);
+   const asset price = eosiosystem::ram_quote(EOS).cost_with_fee(ram_inventory_refill);
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.ram_inventory.emplace(row.ram_available() + bytes);
+      row.ram_price.emplace(price);
+   });
+}
+
+void drops::credit(action_context& ctx, name account, asset quantity, name ram_payer, const std::string& memo)
+{
+   if (quantity.amount <= 0) {
+      return;
+   }
+
+   // Accounts that opted into autopay are paid right away, everyone else
+   // accrues a balance to claim later
+   balance_table balances(_self, _self.value);
+   auto          balance_itr = balances.find(account.value);
+   if (balance_itr != balances.end() && balance_itr->autopay) {
+      token::transfer_action transfer_act{"eosio.token"_n, {{_self, "active"_n}}};
+      transfer_act.send(_self, account, quantity, memo);
+      ctx.pay_out(quantity);
+      return;
+   }
+
+   if (balance_itr != balances.end()) {
+      balances.modify(balance_itr, same_payer, [&](auto& row) { row.balance += quantity; });
+   } else {
+      balances.emplace(ram_payer, [&](auto& row) {
+         row.account = account;
+         row.balance = quantity;
+         row.autopay = false;
+      });
+   }
+   ctx.update_state([&](auto& row) {
+      row.extend();
+      row.owed.emplace(row.owed_balances() + quantity);
    });
 }
 
+asset drops::credit_change(action_context& ctx, name account, asset change)
+{
+   if (change.amount <= 0 || has_balance_row(account)) {
+      credit(ctx, account, change, _self, "");
+      return asset{0, EOS};
+   }
+
+   // Change that does not cover a balance row of its own is sent back instead
+   const asset row_cost = quote_ram(ctx, balances_row);
+   if (change.amount <= row_cost.amount) {
+      token::transfer_action transfer_act{"eosio.token"_n, {{_self, "active"_n}}};
+      transfer_act.send(_self, account, change, "Change from RAM purchase");
+      ctx.pay_out(change);
+      return asset{0, EOS};
+   }
+
+   allocate_ram(ctx, balances_row);
+   credit(ctx, account, change - row_cost, _self, "");
+   return row_cost;
+}
+
+name drops::drop_payer(const drop_row& drop)
+{
+   // Bound drops are paid for by their owner, except the drops given out by init
+   if (drop.bound && drop.seed != 0 && drop.seed != greymass_seed) {
+      return drop.owner;
+   }
+   return _self;
+}
+
 [[eosio::action]] void drops::wipe()
 {
    require_auth(_self);
 
+   // Scopes cannot be listed on chain, so unbind pages are erased for every
+   // account the contract knows of. An account that never held a drop and
+   // still has pages removes them with cancelunbind.
+   const auto erase_pages = [&](name owner) {
+      drops::unbind_page_table pages(_self, owner.value);
+      auto                     pages_itr = pages.begin();
+      while (pages_itr != pages.end()) {
+         pages_itr = pages.erase(pages_itr);
+      }
+   };
+
+   drops::unbind_table unbinds(_self, _self.value);
+   auto                unbind_itr = unbinds.begin();
+   while (unbind_itr != unbinds.end()) {
+      erase_pages(unbind_itr->owner);
+      unbind_itr = unbinds.erase(unbind_itr);
+   }
+
    drops::account_table accounts(_self, _self.value);
    auto                 account_itr = accounts.begin();
    while (account_itr != accounts.end()) {
+      erase_pages(account_itr->account);
       account_itr = accounts.erase(account_itr);
    }
 
@@ -758,6 +1994,14 @@ drops::epoch_row drops::advance_epoch()
       drops_itr = drops.erase(drops_itr);
    }
 
+   drops::seed_table seed_owners(_self, _self.value);
+   auto              seed_itr = seed_owners.begin();
+   while (seed_itr != seed_owners.end()) {
+      drops::owner_drop_table owner_drops(_self, seed_itr->owner.value);
+      owner_drops.erase(owner_drops.find(seed_itr->seed));
+      seed_itr = seed_owners.erase(seed_itr);
+   }
+
    drops::stat_table stats(_self, _self.value);
    auto              stats_itr = stats.begin();
    while (stats_itr != stats.end()) {
@@ -769,6 +2013,20 @@ drops::epoch_row drops::advance_epoch()
    while (state_itr != state.end()) {
       state_itr = state.erase(state_itr);
    }
+
+   drops::mintjob_table mintjobs(_self, _self.value);
+   auto                 mintjob_itr = mintjobs.begin();
+   while (mintjob_itr != mintjobs.end()) {
+      mintjob_itr = mintjobs.erase(mintjob_itr);
+   }
+
+   // The owed total was erased with the state, so the balances it covered go too
+   drops::balance_table balances(_self, _self.value);
+   auto                 balance_itr = balances.begin();
+   while (balance_itr != balances.end()) {
+      erase_pages(balance_itr->account);
+      balance_itr = balances.erase(balance_itr);
+   }
 }
 
 [[eosio::action]] void drops::wipesome()
@@ -786,18 +2044,18 @@ drops::epoch_row drops::advance_epoch()
       i++;
       drops_itr = drops.erase(drops_itr);
    }
-}
 
-std::vector<std::string> drops::split(const std::string& str, char delim)
-{
-   std::vector<std::string> strings;
-   size_t                   start;
-   size_t                   end = 0;
-   while ((start = str.find_first_not_of(delim, end)) != std::string::npos) {
-      end = str.find(delim, start);
-      strings.push_back(str.substr(start, end - start));
+   drops::seed_table seed_owners(_self, _self.value);
+   auto              seed_itr = seed_owners.begin();
+   while (seed_itr != seed_owners.end()) {
+      if (i++ > max) {
+         break;
+      }
+      i++;
+      drops::owner_drop_table owner_drops(_self, seed_itr->owner.value);
+      owner_drops.erase(owner_drops.find(seed_itr->seed));
+      seed_itr = seed_owners.erase(seed_itr);
    }
-   return strings;
 }
 
 } // namespace dropssystem
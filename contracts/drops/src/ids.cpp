@@ -0,0 +1,82 @@
+#include <drops/ids.hpp>
+
+#include <algorithm>
+
+namespace dropssystem {
+
+// A uint64_t needs at most 10 LEB128 bytes
+static constexpr size_t varint_max_size = 10;
+
+std::vector<char> pack_drop_ids(std::vector<uint64_t> ids)
+{
+   std::sort(ids.begin(), ids.end());
+
+   std::vector<char> data;
+   data.reserve(ids.size() * 3);
+   uint64_t previous = 0;
+   for (size_t i = 0; i < ids.size(); i++) {
+      if (i > 0 && ids[i] == previous) {
+         eosio::check(false, "Duplicate drop id " + std::to_string(ids[i]) + ".");
+      }
+      uint64_t value = ids[i] - previous;
+      do {
+         uint8_t byte = value & 0x7F;
+         value >>= 7;
+         data.push_back(value ? byte | 0x80 : byte);
+      } while (value);
+      previous = ids[i];
+   }
+   return data;
+}
+
+packed_drop_ids::iterator::iterator(const char* pos, const char* end)
+   : current(pos)
+   , next(pos)
+   , end(end)
+{
+   decode(true);
+}
+
+packed_drop_ids::iterator& packed_drop_ids::iterator::operator++()
+{
+   current = next;
+   decode(false);
+   return *this;
+}
+
+void packed_drop_ids::iterator::decode(bool first)
+{
+   if (current == end) {
+      current = nullptr;
+      return;
+   }
+
+   uint64_t value = 0;
+   uint32_t shift = 0;
+   for (;; shift += 7) {
+      eosio::check(next != end, "Packed drop ids end in the middle of a value.");
+      eosio::check(size_t(next - current) < varint_max_size, "Packed drop id value is too long.");
+      const uint8_t byte = *next++;
+      value |= uint64_t(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+         eosio::check(shift < 63 || byte <= 1, "Packed drop id value overflows.");
+         break;
+      }
+   }
+
+   if (first) {
+      id = value;
+   } else {
+      // A zero delta is a duplicate id, and the sum must not wrap around
+      eosio::check(value > 0, "Packed drop ids must be strictly ascending.");
+      eosio::check(id + value > id, "Packed drop id value overflows.");
+      id += value;
+   }
+}
+
+size_t packed_drop_ids::size() const
+{
+   return std::count_if(data.begin(), data.end(), [](char byte) { return !(byte & 0x80); });
+}
+
+} // namespace dropssystem
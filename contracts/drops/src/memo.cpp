@@ -0,0 +1,101 @@
+#include <drops/memo.hpp>
+
+#include <algorithm>
+
+namespace dropssystem {
+
+struct memo_keyword
+{
+   std::string_view keyword;
+   memo_command     command;
+};
+
+// Keyword commands recognized in the leading field of a memo
+static constexpr memo_keyword memo_commands[] = {
+   {"unbind", memo_command::unbind},
+   {"deposit", memo_command::deposit},
+};
+
+bool parse_uint32(std::string_view str, uint32_t& value)
+{
+   // The largest uint32_t has 10 digits
+   if (str.empty() || str.size() > 10) {
+      return false;
+   }
+
+   uint64_t result = 0;
+   for (char c : str) {
+      if (c < '0' || c > '9') {
+         return false;
+      }
+      result = result * 10 + (c - '0');
+   }
+
+   if (result > UINT32_MAX) {
+      return false;
+   }
+   value = result;
+   return true;
+}
+
+std::vector<uint64_t> parse_drop_ids(std::string_view list)
+{
+   std::vector<uint64_t> ids;
+   ids.reserve(std::count(list.begin(), list.end(), ',') + 1);
+
+   while (true) {
+      const size_t           delim = list.find(',');
+      const std::string_view field = list.substr(0, delim);
+
+      // The largest uint64_t has 20 digits
+      uint64_t value = 0;
+      eosio::check(!field.empty() && field.size() <= 20, "Drop ids must be valid numbers.");
+      for (char c : field) {
+         eosio::check(c >= '0' && c <= '9', "Drop ids must be valid numbers.");
+         eosio::check(value <= (UINT64_MAX - (c - '0')) / 10, "Drop ids must be valid numbers.");
+         value = value * 10 + (c - '0');
+      }
+      ids.push_back(value);
+
+      if (delim == std::string_view::npos) {
+         return ids;
+      }
+      list.remove_prefix(delim + 1);
+   }
+}
+
+parsed_memo parse_memo(std::string_view memo)
+{
+   // Split off the leading field
+   const size_t           delim = memo.find(',');
+   const std::string_view head  = memo.substr(0, delim);
+   const std::string_view args  = delim == std::string_view::npos ? std::string_view{} : memo.substr(delim + 1);
+
+   for (const auto& entry : memo_commands) {
+      if (head != entry.keyword) {
+         continue;
+      }
+      switch (entry.command) {
+      case memo_command::unbind:
+         eosio::check(delim == std::string_view::npos || !args.empty(),
+                      "Memo data must use format: unbind or unbind,<drop_id>,<drop_id>,...");
+         return {memo_command::unbind, 0, args};
+      case memo_command::deposit:
+         eosio::check(delim == std::string_view::npos, "Memo data must only contain 1 value of 'deposit'.");
+         return {memo_command::deposit, 0, {}};
+      default:
+         eosio::check(false, "Unsupported memo command.");
+      }
+   }
+
+   // Anything else is a generate command in the format <amount>,<data>
+   eosio::check(delim != std::string_view::npos && !args.empty() && args.find(',') == std::string_view::npos,
+                "Memo data must contain 2 values, seperated by a comma using format: <drops_amount>,<drops_data>");
+
+   uint32_t amount;
+   eosio::check(parse_uint32(head, amount), "The amount of drops to generate must be a valid number.");
+
+   return {memo_command::generate, amount, args};
+}
+
+} // namespace dropssystem
@@ -0,0 +1,52 @@
+#include <drops/seed.hpp>
+
+namespace dropssystem {
+
+seed_generator::seed_generator(std::string_view data, uint8_t generation)
+   : generation(generation)
+   , buffer(v2_prefix.length() + max_digits + data.length())
+{
+   eosio::check(generation == generation_v1 || generation == generation_v2, "Unknown seed generation mode.");
+
+   // Reserve room for the prefix and index in front of the data
+   memcpy(buffer.data() + v2_prefix.length() + max_digits, data.data(), data.length());
+}
+
+std::array<uint8_t, 32> seed_generator::hash(uint64_t index)
+{
+   // Write the decimal index right-aligned against the data
+   char* start = buffer.data() + v2_prefix.length() + max_digits;
+   do {
+      *--start = '0' + (index % 10);
+      index /= 10;
+   } while (index > 0);
+
+   if (generation == generation_v2) {
+      start -= v2_prefix.length();
+      memcpy(start, v2_prefix.data(), v2_prefix.length());
+   }
+
+   return eosio::sha256(start, buffer.data() + buffer.size() - start).extract_as_byte_array();
+}
+
+uint64_t seed_generator::derive(uint64_t index)
+{
+   uint64_t seed;
+   if (generation == generation_v1) {
+      auto byte_array = hash(index);
+      memcpy(&seed, byte_array.data(), sizeof(uint64_t));
+      return seed;
+   }
+
+   // Only rehash once every seeds_per_digest indices
+   const uint64_t block = index / seeds_per_digest;
+   if (!digest_cached || digest_index != block) {
+      digest        = hash(block);
+      digest_index  = block;
+      digest_cached = true;
+   }
+   memcpy(&seed, digest.data() + (index % seeds_per_digest) * sizeof(uint64_t), sizeof(uint64_t));
+   return seed;
+}
+
+} // namespace dropssystem
@@ -0,0 +1,41 @@
+#include <drops/visit.hpp>
+
+#include <string>
+
+namespace dropssystem {
+
+void fail_drop(drop_error error, uint64_t seed)
+{
+   const std::string id = std::to_string(seed);
+   std::string       message;
+   switch (error) {
+   case drop_error::duplicate:
+      message = "Drop " + id + " was provided more than once.";
+      break;
+   case drop_error::not_found:
+      message = "Drop " + id + " not found";
+      break;
+   case drop_error::not_owned:
+      message = "Drop " + id + " does not belong to account.";
+      break;
+   case drop_error::not_owned_transfer:
+      message = "Account does not own drop" + id;
+      break;
+   case drop_error::not_bound:
+      message = "Drop " + id + " is not bound.";
+      break;
+   case drop_error::already_bound:
+      message = "Drop " + id + " is already bound.";
+      break;
+   case drop_error::bound_transfer:
+      message = "Drop " + id + " is bound and cannot be transferred";
+      break;
+   case drop_error::no_owner_index:
+      message = "Drop " + id + " has no owner index entry.";
+      break;
+   }
+   eosio::check(false, message);
+   __builtin_unreachable();
+}
+
+} // namespace dropssystem
@@ -0,0 +1,74 @@
+#include <drops/bancor.hpp>
+
+#include "bancor_reference.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace eosiosystem;
+
+// Times the integer conversions against the double precision versions of the
+// system contract, over reserves and amounts in the range bancor_test samples
+
+namespace {
+
+// Keeps the results observable so the timed loops are not optimized away
+volatile int64_t result_sink;
+
+struct sample
+{
+   int64_t ram_reserve;
+   int64_t eos_reserve;
+   int64_t amount;
+};
+
+template <typename Fn> double time_ns(const std::vector<sample>& samples, Fn&& fn)
+{
+   constexpr int rounds = 20;
+   int64_t       sink   = 0;
+   const auto    start  = std::chrono::steady_clock::now();
+   for (int round = 0; round < rounds; round++) {
+      for (const sample& s : samples) {
+         sink += fn(s);
+      }
+   }
+   const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+   result_sink = sink;
+   return elapsed / rounds / samples.size();
+}
+
+void report(const char* label, double integer, double reference)
+{
+   std::printf("%-18s integer %6.2f ns  double %6.2f ns\n", label, integer, reference);
+}
+
+} // namespace
+
+int main()
+{
+   std::mt19937_64                        rng(1);
+   std::uniform_int_distribution<int64_t> ram_reserves(int64_t(1) << 30, int64_t(1) << 40);
+   std::uniform_int_distribution<int64_t> eos_reserves(int64_t(1e7), int64_t(1e13));
+   std::uniform_int_distribution<int64_t> amounts(1, int64_t(1) << 24);
+
+   std::vector<sample> samples(1000000);
+   for (sample& s : samples) {
+      s = {ram_reserves(rng), eos_reserves(rng), amounts(rng)};
+   }
+
+   report("get_bancor_input",
+          time_ns(samples, [](const sample& s) { return get_bancor_input(s.ram_reserve, s.eos_reserve, s.amount); }),
+          time_ns(samples, [](const sample& s) {
+             return reference::get_bancor_input(s.ram_reserve, s.eos_reserve, s.amount);
+          }));
+   report("get_bancor_output",
+          time_ns(samples, [](const sample& s) { return get_bancor_output(s.ram_reserve, s.eos_reserve, s.amount); }),
+          time_ns(samples, [](const sample& s) {
+             return reference::get_bancor_output(s.ram_reserve, s.eos_reserve, s.amount);
+          }));
+   report("add_ram_fee", time_ns(samples, [](const sample& s) { return add_ram_fee(s.eos_reserve); }),
+          time_ns(samples, [](const sample& s) { return reference::add_ram_fee(s.eos_reserve); }));
+   return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// The double precision versions of the system contract, from exchange_state.cpp
+// and the buyrambytes action of eosio.system.cpp
+namespace reference {
+
+inline int64_t get_bancor_input(int64_t out_reserve, int64_t inp_reserve, int64_t out)
+{
+   const double ob = out_reserve;
+   const double ib = inp_reserve;
+
+   int64_t inp = (ib * out) / (ob - out);
+   if (inp < 0)
+      inp = 0;
+
+   return inp;
+}
+
+inline int64_t get_bancor_output(int64_t inp_reserve, int64_t out_reserve, int64_t inp)
+{
+   const double ib = inp_reserve;
+   const double ob = out_reserve;
+   const double in = inp;
+
+   int64_t out = int64_t((in * ob) / (ib + in));
+   if (out < 0)
+      out = 0;
+
+   return out;
+}
+
+inline int64_t add_ram_fee(int64_t cost) { return cost / double(0.995); }
+
+} // namespace reference
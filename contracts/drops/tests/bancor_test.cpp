@@ -0,0 +1,107 @@
+#include <drops/bancor.hpp>
+
+#include "bancor_reference.hpp"
+#include "test.hpp"
+
+#include <cstdlib>
+#include <random>
+
+using namespace eosiosystem;
+
+namespace {
+
+struct differences
+{
+   uint64_t compared = 0;
+   uint64_t differed = 0;
+   int64_t  largest  = 0;
+
+   void add(int64_t exact, int64_t rounded)
+   {
+      const int64_t difference = std::llabs(exact - rounded);
+      compared++;
+      differed += difference != 0;
+      largest = std::max(largest, difference);
+   }
+
+   void print(const char* label) const
+   {
+      std::printf("%-18s %8llu compared, %6llu differ, largest difference %lld\n", label,
+                  (unsigned long long)compared, (unsigned long long)differed, (long long)largest);
+   }
+};
+
+void test_matches_within_one_unit()
+{
+   // Reserves from a young market up to well past the current EOS mainnet
+   // market, RAM reserves in bytes and EOS reserves in 0.0001 EOS
+   std::mt19937_64                        rng(1);
+   std::uniform_int_distribution<int64_t> ram_reserves(int64_t(1) << 30, int64_t(1) << 40);
+   std::uniform_int_distribution<int64_t> eos_reserves(int64_t(1e7), int64_t(1e13));
+   std::uniform_int_distribution<int64_t> amounts(1, int64_t(1) << 24);
+
+   differences input, output, fee;
+   for (int i = 0; i < 1000000; i++) {
+      const int64_t ram_reserve = ram_reserves(rng);
+      const int64_t eos_reserve = eos_reserves(rng);
+      const int64_t bytes       = amounts(rng);
+
+      const int64_t cost = get_bancor_input(ram_reserve, eos_reserve, bytes);
+      input.add(cost, reference::get_bancor_input(ram_reserve, eos_reserve, bytes));
+      output.add(get_bancor_output(ram_reserve, eos_reserve, bytes),
+                 reference::get_bancor_output(ram_reserve, eos_reserve, bytes));
+      fee.add(add_ram_fee(cost), reference::add_ram_fee(cost));
+   }
+
+   // Reserves chosen so the exact quotient is an integer, where the rounding of
+   // the double products decides which side of it the system contract lands on
+   for (int i = 0; i < 1000000; i++) {
+      const int64_t bytes       = amounts(rng);
+      const int64_t ram_reserve = bytes + amounts(rng) * 64;
+      const int64_t eos_reserve = (ram_reserve - bytes) * (1 + int64_t(rng() % 4096));
+      input.add(get_bancor_input(ram_reserve, eos_reserve, bytes),
+                reference::get_bancor_input(ram_reserve, eos_reserve, bytes));
+
+      const int64_t proceeds_reserve = (ram_reserve + bytes) * (1 + int64_t(rng() % 4096));
+      output.add(get_bancor_output(ram_reserve, proceeds_reserve, bytes),
+                 reference::get_bancor_output(ram_reserve, proceeds_reserve, bytes));
+
+      // Up to about 680 million EOS, well past any single RAM purchase
+      const int64_t cost = 199 * (amounts(rng) << 10 | int64_t(rng() % 1024));
+      fee.add(add_ram_fee(cost), reference::add_ram_fee(cost));
+   }
+
+   input.print("get_bancor_input");
+   output.print("get_bancor_output");
+   fee.print("add_ram_fee");
+   EXPECT(input.largest <= 1);
+   EXPECT(output.largest <= 1);
+   EXPECT(fee.largest <= 1);
+}
+
+void test_exact_values()
+{
+   // Quotients that are exact integers are never truncated below them
+   EXPECT(get_bancor_input(1000, 1000, 500) == 1000);
+   EXPECT(get_bancor_output(1000, 1000, 1000) == 500);
+   EXPECT(add_ram_fee(199) == 200);
+   EXPECT(subtract_ram_fee(200) == 199);
+   EXPECT(subtract_ram_fee(201) == 199);
+   EXPECT(get_bancor_input(1000, 1000, 0) == 0);
+   EXPECT(get_bancor_output(1000, 1000, 0) == 0);
+}
+
+void test_rejects_buying_the_reserve()
+{
+   EXPECT_ABORT(get_bancor_input(1000, 1000, 1000), "does not have enough RAM");
+}
+
+} // namespace
+
+int main()
+{
+   test_matches_within_one_unit();
+   test_exact_values();
+   test_rejects_buying_the_reserve();
+   return dropstest::finish("bancor_test");
+}
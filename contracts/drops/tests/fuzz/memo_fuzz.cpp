@@ -0,0 +1,38 @@
+#include <drops/memo.hpp>
+
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace dropssystem;
+
+// libFuzzer entry point for the memo parser. Malformed memos must abort with a
+// check, anything else, including a parse that breaks the invariants of its
+// command, is reported as a crash. memo_test replays the corpus through it.
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+   const std::string_view memo(reinterpret_cast<const char*>(data), size);
+
+   try {
+      const parsed_memo parsed = parse_memo(memo);
+      switch (parsed.command) {
+      case memo_command::generate:
+         if (parsed.data.empty() || parsed.data.find(',') != std::string_view::npos) {
+            std::abort();
+         }
+         break;
+      case memo_command::unbind:
+         if (!parsed.data.empty() && parse_drop_ids(parsed.data).empty()) {
+            std::abort();
+         }
+         break;
+      case memo_command::deposit:
+         if (!parsed.data.empty()) {
+            std::abort();
+         }
+         break;
+      }
+   } catch (const std::runtime_error&) {
+   }
+   return 0;
+}
@@ -0,0 +1,63 @@
+#include <drops/ids.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace dropssystem;
+
+// Compares the action data size of a packed id list against the uint64[] the
+// unpacked actions take, and times decoding it
+
+namespace {
+
+// Bytes of the varuint32 length prefix the ABI writes before a vector
+size_t length_prefix(size_t size)
+{
+   size_t bytes = 1;
+   while (size >>= 7) {
+      bytes++;
+   }
+   return bytes;
+}
+
+void report(const char* label, const std::vector<uint64_t>& ids)
+{
+   const std::vector<char> data     = pack_drop_ids(ids);
+   const size_t            unpacked = length_prefix(ids.size()) + ids.size() * sizeof(uint64_t);
+   const size_t            packed   = length_prefix(data.size()) + data.size();
+
+   constexpr int rounds = 200;
+   uint64_t      sum    = 0;
+   const auto    start  = std::chrono::steady_clock::now();
+   for (int round = 0; round < rounds; round++) {
+      for (uint64_t id : packed_drop_ids(data)) {
+         sum += id;
+      }
+   }
+   const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+   std::printf("%-22s %6zu ids  uint64[] %7zu B  packed %7zu B  %5.1f%%  decode %5.2f ns/id  (%llu)\n", label,
+               ids.size(), unpacked, packed, 100.0 * packed / unpacked, elapsed / rounds / ids.size(),
+               (unsigned long long)(sum & 0xFF));
+}
+
+} // namespace
+
+int main()
+{
+   std::mt19937_64 rng(1);
+   for (size_t count : {100, 1000, 5000}) {
+      std::vector<uint64_t> consecutive(count), sparse(count), seeds(count);
+      for (size_t i = 0; i < count; i++) {
+         consecutive[i] = 1000000 + i;
+         sparse[i]      = 1000000 + i * 1000 + rng() % 1000;
+         seeds[i]       = rng();
+      }
+      std::printf("\n");
+      report("consecutive", consecutive);
+      report("gaps of ~1000", sparse);
+      report("random 64-bit seeds", seeds);
+   }
+   return 0;
+}
@@ -0,0 +1,114 @@
+#include <drops/ids.hpp>
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <random>
+
+using namespace dropssystem;
+
+namespace {
+
+std::vector<uint64_t> decode(const std::vector<char>& data)
+{
+   packed_drop_ids       ids(data);
+   std::vector<uint64_t> decoded;
+   for (uint64_t id : ids) {
+      decoded.push_back(id);
+   }
+   return decoded;
+}
+
+void round_trip(std::vector<uint64_t> ids)
+{
+   const std::vector<char> data = pack_drop_ids(ids);
+   std::sort(ids.begin(), ids.end());
+   EXPECT(decode(data) == ids);
+   EXPECT(packed_drop_ids(data).size() == ids.size());
+}
+
+void test_round_trip()
+{
+   round_trip({});
+   round_trip({0});
+   round_trip({UINT64_MAX});
+   round_trip({0, UINT64_MAX});
+   round_trip({127, 128, 16383, 16384});
+   round_trip({5, 3, 9, 1});
+
+   std::vector<uint64_t> consecutive(5000);
+   for (size_t i = 0; i < consecutive.size(); i++) {
+      consecutive[i] = 1000000 + i;
+   }
+   round_trip(consecutive);
+
+   // Drop seeds are uniformly distributed 64-bit values
+   std::mt19937_64       rng(1);
+   std::vector<uint64_t> seeds(5000);
+   for (auto& seed : seeds) {
+      seed = rng();
+   }
+   round_trip(seeds);
+}
+
+void test_packed_size()
+{
+   // Consecutive ids take one byte each after the first
+   EXPECT(pack_drop_ids({1000, 1001, 1002}).size() == 2 + 1 + 1);
+   EXPECT(pack_drop_ids({UINT64_MAX}).size() == 10);
+}
+
+void test_rejects_duplicates()
+{
+   EXPECT_ABORT(pack_drop_ids({4, 2, 4}), "Duplicate drop id 4.");
+}
+
+void test_rejects_truncated()
+{
+   // 300 is encoded in two bytes, the second is cut off
+   std::vector<char> data = pack_drop_ids({1, 301});
+   data.pop_back();
+   EXPECT_ABORT(decode(data), "end in the middle of a value");
+   EXPECT_ABORT(decode({char(0x80)}), "end in the middle of a value");
+}
+
+void test_rejects_over_long()
+{
+   // Eleven bytes cannot be a canonical uint64_t, even with zero payload
+   std::vector<char> data(10, char(0x80));
+   data.push_back(0x00);
+   EXPECT_ABORT(decode(data), "value is too long");
+}
+
+void test_rejects_overflow()
+{
+   // The tenth byte of a uint64_t can only carry its top bit
+   std::vector<char> data(9, char(0xFF));
+   data.push_back(0x02);
+   EXPECT_ABORT(decode(data), "overflows");
+
+   // A delta that wraps the sum around
+   std::vector<char> wrap = pack_drop_ids({UINT64_MAX});
+   wrap.push_back(0x01);
+   EXPECT_ABORT(decode(wrap), "overflows");
+}
+
+void test_rejects_non_ascending()
+{
+   EXPECT_ABORT(decode({5, 0}), "strictly ascending");
+   EXPECT_ABORT(decode({5, 1, 0, 3}), "strictly ascending");
+}
+
+} // namespace
+
+int main()
+{
+   test_round_trip();
+   test_packed_size();
+   test_rejects_duplicates();
+   test_rejects_truncated();
+   test_rejects_over_long();
+   test_rejects_overflow();
+   test_rejects_non_ascending();
+   return dropstest::finish("ids_test");
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Native stand-in for the CDT header, providing only what the sources under
+// test use. A failed check throws so tests can assert on the abort message.
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace eosio {
+
+inline void check(bool pred, const char* msg)
+{
+   if (!pred) {
+      throw std::runtime_error(msg);
+   }
+}
+
+inline void check(bool pred, const std::string& msg)
+{
+   if (!pred) {
+      throw std::runtime_error(msg);
+   }
+}
+
+} // namespace eosio
@@ -0,0 +1,46 @@
+#include <drops/memo.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace dropssystem;
+
+// Times parse_memo on the memos the contract receives, and parse_drop_ids on
+// unbind lists of increasing length
+
+namespace {
+
+template <typename Fn> double time_ns(int rounds, Fn&& fn)
+{
+   const auto start = std::chrono::steady_clock::now();
+   for (int round = 0; round < rounds; round++) {
+      fn();
+   }
+   return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+} // namespace
+
+int main()
+{
+   constexpr int rounds = 200000;
+   uint64_t      sink   = 0;
+
+   for (const char* memo : {"10,a5f1e2c3d4b5a6978812233445566778899aabbccddeeff", "unbind", "deposit"}) {
+      const double ns = time_ns(rounds, [&] { sink += parse_memo(memo).amount; });
+      std::printf("parse_memo     %-52s %7.1f ns\n", memo, ns);
+   }
+
+   for (size_t count : {10, 100, 1000}) {
+      std::string list;
+      for (size_t i = 0; i < count; i++) {
+         list += (i ? "," : "") + std::to_string(7338027470446133248ULL + i * 7919);
+      }
+      const double ns = time_ns(rounds / int(count), [&] { sink += parse_drop_ids(list).size(); });
+      std::printf("parse_drop_ids %5zu ids %40s %7.1f ns, %5.1f ns/id\n", count, "", ns, ns / count);
+   }
+
+   std::printf("(%llu)\n", (unsigned long long)(sink & 0xFF));
+   return 0;
+}
@@ -0,0 +1,113 @@
+#include <drops/memo.hpp>
+
+#include "test.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace dropssystem;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+bool parses_uint32(std::string_view str, uint32_t expected)
+{
+   uint32_t value = 0;
+   return parse_uint32(str, value) && value == expected;
+}
+
+bool rejects_uint32(std::string_view str)
+{
+   uint32_t value = 0;
+   return !parse_uint32(str, value);
+}
+
+void test_parse_uint32()
+{
+   EXPECT(parses_uint32("0", 0));
+   EXPECT(parses_uint32("42", 42));
+   EXPECT(parses_uint32("0042", 42));
+   EXPECT(parses_uint32("4294967295", UINT32_MAX));
+   EXPECT(rejects_uint32("4294967296"));
+   EXPECT(rejects_uint32("9999999999"));
+   EXPECT(rejects_uint32("00000000001"));
+   EXPECT(rejects_uint32(""));
+   EXPECT(rejects_uint32("+1"));
+   EXPECT(rejects_uint32("-1"));
+   EXPECT(rejects_uint32(" 1"));
+   EXPECT(rejects_uint32("1 "));
+   EXPECT(rejects_uint32("1a"));
+}
+
+void test_parse_drop_ids()
+{
+   EXPECT(parse_drop_ids("7") == std::vector<uint64_t>{7});
+   EXPECT(parse_drop_ids("3,1,2") == (std::vector<uint64_t>{3, 1, 2}));
+   EXPECT(parse_drop_ids("0,18446744073709551615") == (std::vector<uint64_t>{0, UINT64_MAX}));
+
+   EXPECT_ABORT(parse_drop_ids(""), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids("18446744073709551616"), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids("000000000000000000001"), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids("1,,2"), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids("1,"), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids(",1"), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids("1, 2"), "valid numbers");
+   EXPECT_ABORT(parse_drop_ids("0x10"), "valid numbers");
+}
+
+void test_parse_memo()
+{
+   parsed_memo generate = parse_memo("10,seeddata");
+   EXPECT(generate.command == memo_command::generate);
+   EXPECT(generate.amount == 10);
+   EXPECT(generate.data == "seeddata");
+
+   parsed_memo unbind = parse_memo("unbind");
+   EXPECT(unbind.command == memo_command::unbind);
+   EXPECT(unbind.data.empty());
+
+   parsed_memo unbind_ids = parse_memo("unbind,1,2");
+   EXPECT(unbind_ids.command == memo_command::unbind);
+   EXPECT(unbind_ids.data == "1,2");
+
+   EXPECT(parse_memo("deposit").command == memo_command::deposit);
+
+   EXPECT_ABORT(parse_memo("unbind,"), "unbind or unbind,<drop_id>");
+   EXPECT_ABORT(parse_memo("deposit,1"), "1 value of 'deposit'");
+   EXPECT_ABORT(parse_memo(""), "2 values");
+   EXPECT_ABORT(parse_memo("10"), "2 values");
+   EXPECT_ABORT(parse_memo("10,"), "2 values");
+   EXPECT_ABORT(parse_memo("10,a,b"), "2 values");
+   EXPECT_ABORT(parse_memo("ten,data"), "valid number");
+   EXPECT_ABORT(parse_memo("4294967296,data"), "valid number");
+   EXPECT_ABORT(parse_memo("Unbind"), "2 values");
+}
+
+// Every corpus entry goes through the fuzz target, which aborts the process
+// when a parse breaks its invariants
+void test_fuzz_corpus(const char* corpus)
+{
+   size_t entries = 0;
+   for (const auto& entry : std::filesystem::directory_iterator(corpus)) {
+      std::ifstream     file(entry.path(), std::ios::binary);
+      const std::string memo((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(memo.data()), memo.size());
+      entries++;
+   }
+   EXPECT(entries > 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+   test_parse_uint32();
+   test_parse_drop_ids();
+   test_parse_memo();
+   if (argc > 1) {
+      test_fuzz_corpus(argv[1]);
+   }
+   return dropstest::finish("memo_test");
+}
@@ -0,0 +1,83 @@
+#include <drops/seed.hpp>
+
+#include "test.hpp"
+
+#include <string>
+
+using namespace dropssystem;
+
+namespace {
+
+// First 8 bytes of sha256(input), as the contract read seeds before seed_generator
+uint64_t seed_word(const std::string& input, size_t word)
+{
+   const auto digest = eosio::sha256(input.data(), input.size()).extract_as_byte_array();
+   uint64_t   seed;
+   memcpy(&seed, digest.data() + word * sizeof(uint64_t), sizeof(uint64_t));
+   return seed;
+}
+
+void test_sha256()
+{
+   // FIPS 180-4 example, so the stand-in digest can be trusted below
+   const auto digest = eosio::sha256("abc", 3).extract_as_byte_array();
+   EXPECT(digest[0] == 0xba && digest[1] == 0x78 && digest[30] == 0x15 && digest[31] == 0xad);
+}
+
+void test_v1_input()
+{
+   for (const std::string data : {"", "a", "a5f1e2c3d4b5a6978812233445566778899aabbccddeeff"}) {
+      seed_generator generator(data);
+      for (uint64_t index : {uint64_t(0), uint64_t(1), uint64_t(9), uint64_t(10), uint64_t(4999), uint64_t(12345678),
+                             UINT64_MAX}) {
+         const std::string expected = std::to_string(index) + data;
+         const uint64_t    seed     = generator.derive(index);
+         EXPECT(eosio::testing::last_sha256_input == expected);
+         EXPECT(seed == seed_word(expected, 0));
+      }
+   }
+}
+
+void test_v2_input()
+{
+   const std::string data = "a5f1e2c3d4b5a6978812233445566778899aabbccddeeff";
+   seed_generator    generator(data, generation_v2);
+   for (uint64_t index = 0; index < 5000; index++) {
+      const std::string expected = "v2:" + std::to_string(index / 4) + data;
+      const uint64_t    seed     = generator.derive(index);
+      EXPECT(eosio::testing::last_sha256_input == expected);
+      EXPECT(seed == seed_word(expected, index % 4));
+   }
+
+   // Indices are not required to be consecutive
+   for (uint64_t index : {UINT64_MAX, uint64_t(7), uint64_t(1000000)}) {
+      const std::string expected = "v2:" + std::to_string(index / 4) + data;
+      EXPECT(generator.derive(index) == seed_word(expected, index % 4));
+      EXPECT(eosio::testing::last_sha256_input == expected);
+   }
+}
+
+void test_v2_reuses_digest()
+{
+   seed_generator generator("data", generation_v2);
+   generator.derive(8);
+   eosio::testing::last_sha256_input.clear();
+   for (uint64_t index = 8; index < 12; index++) {
+      generator.derive(index);
+   }
+   EXPECT(eosio::testing::last_sha256_input.empty());
+}
+
+void test_unknown_generation() { EXPECT_ABORT(seed_generator("data", 3), "Unknown seed generation mode."); }
+
+} // namespace
+
+int main()
+{
+   test_sha256();
+   test_v1_input();
+   test_v2_input();
+   test_v2_reuses_digest();
+   test_unknown_generation();
+   return dropstest::finish("seed_test");
+}
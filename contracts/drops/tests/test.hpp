@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace dropstest {
+
+inline int failures = 0;
+
+inline void expect(bool pass, const char* expr, const char* file, int line)
+{
+   if (!pass) {
+      std::printf("%s:%d: expected %s\n", file, line, expr);
+      failures++;
+   }
+}
+
+// Runs fn and expects it to abort with a message containing message
+inline void expect_abort(const std::function<void()>& fn, const std::string& message, const char* file, int line)
+{
+   try {
+      fn();
+   } catch (const std::runtime_error& e) {
+      if (std::string(e.what()).find(message) == std::string::npos) {
+         std::printf("%s:%d: expected abort \"%s\", got \"%s\"\n", file, line, message.c_str(), e.what());
+         failures++;
+      }
+      return;
+   }
+   std::printf("%s:%d: expected abort \"%s\"\n", file, line, message.c_str());
+   failures++;
+}
+
+inline int finish(const char* name)
+{
+   std::printf("%s: %s\n", name, failures ? "FAILED" : "passed");
+   return failures ? 1 : 0;
+}
+
+} // namespace dropstest
+
+#define EXPECT(expr) dropstest::expect((expr), #expr, __FILE__, __LINE__)
+#define EXPECT_ABORT(stmt, message) dropstest::expect_abort([&] { stmt; }, message, __FILE__, __LINE__)
@@ -0,0 +1,93 @@
+#include <drops/visit.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace dropssystem;
+
+// Times the checks a transfer runs for each of 2000 drops, with the messages
+// concatenated eagerly for every drop as transfer_drops did before check_drop,
+// and with check_drop, which formats them only when a drop fails. Both walk the
+// same rows, so the difference is the cost of the messages alone. In wasm every
+// to_string and concatenation also allocates from the linear memory of the
+// action, which the native heap here hides.
+
+namespace {
+
+struct drop
+{
+   uint64_t seed;
+   uint64_t owner;
+   bool     bound;
+};
+
+// Keeps the results observable so the timed loops are not optimized away
+volatile uint64_t result_sink;
+
+void transfer_eager(const std::vector<drop>& drops, uint64_t from)
+{
+   uint64_t previous = 0;
+   bool     first    = true;
+   uint64_t sink     = 0;
+   for (const drop& row : drops) {
+      eosio::check(first || row.seed > previous, "Drop " + std::to_string(row.seed) + " was provided more than once.");
+      first    = false;
+      previous = row.seed;
+      eosio::check(row.seed != 0, "Drop " + std::to_string(row.seed) + " not found");
+      eosio::check(row.bound == false, "Drop " + std::to_string(row.seed) + " is bound and cannot be transferred");
+      eosio::check(row.owner == from, "Account does not own drop" + std::to_string(row.seed));
+      sink += row.seed;
+   }
+   result_sink = sink;
+}
+
+void transfer_deferred(const std::vector<drop>& drops, uint64_t from)
+{
+   uint64_t previous = 0;
+   bool     first    = true;
+   uint64_t sink     = 0;
+   for (const drop& row : drops) {
+      check_drop(first || row.seed > previous, drop_error::duplicate, row.seed);
+      first    = false;
+      previous = row.seed;
+      check_drop(row.seed != 0, drop_error::not_found, row.seed);
+      check_drop(row.bound == false, drop_error::bound_transfer, row.seed);
+      check_drop(row.owner == from, drop_error::not_owned_transfer, row.seed);
+      sink += row.seed;
+   }
+   result_sink = sink;
+}
+
+template <typename Fn> double time_us(Fn&& fn)
+{
+   constexpr int rounds = 2000;
+   const auto    start  = std::chrono::steady_clock::now();
+   for (int round = 0; round < rounds; round++) {
+      fn();
+   }
+   return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+} // namespace
+
+int main()
+{
+   constexpr uint64_t from  = 1;
+   constexpr size_t   count = 2000;
+
+   // Seeds are large random values on chain, so their decimal strings are long
+   std::vector<drop> drops(count);
+   uint64_t          seed = 1000000000000000000ULL;
+   for (drop& row : drops) {
+      seed += 7919;
+      row = {seed, from, false};
+   }
+
+   const double eager    = time_us([&] { transfer_eager(drops, from); });
+   const double deferred = time_us([&] { transfer_deferred(drops, from); });
+   std::printf("%zu drop transfer  eager messages %8.1f us  check_drop %8.1f us  (%.1fx)\n", count, eager, deferred,
+               eager / deferred);
+   return 0;
+}
@@ -0,0 +1,123 @@
+#include <drops/visit.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace dropssystem;
+
+// Counts the table lookups for_each_drop performs for clustered and random id
+// sets, and times the walk per id. On chain every lookup is a db_lowerbound_i64
+// call and every followed row a db_next_i64 call, both far more expensive than
+// the map used here, so the counts matter more than the native times.
+
+namespace {
+
+struct drop
+{
+   uint64_t seed;
+};
+
+// Stand-in for a multi_index table, counting lower_bound calls and increments
+class table
+{
+public:
+   using rows = std::map<uint64_t, drop>;
+
+   class iterator
+   {
+   public:
+      iterator() = default;
+      iterator(table* owner, rows::iterator itr)
+         : owner(owner)
+         , itr(itr)
+      {}
+
+      const drop* operator->() const { return &itr->second; }
+      iterator&   operator++()
+      {
+         owner->increments++;
+         ++itr;
+         return *this;
+      }
+      bool operator==(const iterator& other) const { return itr == other.itr; }
+      bool operator!=(const iterator& other) const { return itr != other.itr; }
+
+   private:
+      friend class table;
+      table*         owner = nullptr;
+      rows::iterator itr;
+   };
+
+   explicit table(const std::vector<uint64_t>& seeds)
+   {
+      for (uint64_t seed : seeds) {
+         data.emplace(seed, drop{seed});
+      }
+   }
+
+   iterator end() { return {this, data.end()}; }
+   iterator lower_bound(uint64_t id)
+   {
+      lookups++;
+      return {this, data.lower_bound(id)};
+   }
+
+   size_t lookups    = 0;
+   size_t increments = 0;
+
+private:
+   rows data;
+};
+
+// How the visit of an action hands back the next row
+enum class visit_kind
+{
+   unknown, // modify in the global table, transfer, bind and unbind in storage_global
+   advance, // modify in an owner scope, or erase in destroy
+};
+
+void report(const char* label, const std::vector<uint64_t>& table_seeds, std::vector<uint64_t> ids, visit_kind kind)
+{
+   std::sort(ids.begin(), ids.end());
+
+   table      drops(table_seeds);
+   const auto start = std::chrono::steady_clock::now();
+   for_each_drop(drops, ids, [&](table::iterator itr) { return kind == visit_kind::advance ? ++itr : drops.end(); });
+   const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+   std::printf("%-34s %5zu ids  %5zu lookups  %5zu rows followed  %6.1f ns/id\n", label, ids.size(), drops.lookups,
+               drops.increments, elapsed / ids.size());
+}
+
+} // namespace
+
+int main()
+{
+   std::mt19937_64 rng(1);
+
+   // The global table holds the random seeds of every owner
+   std::vector<uint64_t> global(200000);
+   for (uint64_t& seed : global) {
+      seed = rng();
+   }
+
+   for (size_t count : {100, 1000, 5000}) {
+      // An owner scope holds only the drops of its owner, so every id is the
+      // row after the previous one. In the global table the same owner's seeds
+      // are a random sample of it.
+      std::vector<uint64_t> clustered(global.begin(), global.begin() + count);
+      std::vector<uint64_t> random;
+      std::sample(global.begin(), global.end(), std::back_inserter(random), count, rng);
+
+      std::printf("\n");
+      report("owner scope, advance", clustered, clustered, visit_kind::advance);
+      report("owner scope, unknown next", clustered, clustered, visit_kind::unknown);
+      report("global table, advance", global, random, visit_kind::advance);
+      report("global table, unknown next", global, random, visit_kind::unknown);
+   }
+   return 0;
+}
@@ -0,0 +1,101 @@
+#include <drops/visit.hpp>
+
+#include "test.hpp"
+
+#include <map>
+#include <vector>
+
+using namespace dropssystem;
+
+namespace {
+
+struct drop
+{
+   uint64_t seed;
+};
+
+// Minimal table with the parts of multi_index for_each_drop uses
+struct table
+{
+   struct iterator
+   {
+      std::map<uint64_t, drop>::iterator itr;
+
+      const drop* operator->() const { return &itr->second; }
+      bool        operator==(const iterator& other) const { return itr == other.itr; }
+      bool        operator!=(const iterator& other) const { return itr != other.itr; }
+   };
+
+   std::map<uint64_t, drop> rows;
+   size_t                   lookups = 0;
+
+   iterator end() { return {rows.end()}; }
+   iterator lower_bound(uint64_t id)
+   {
+      lookups++;
+      return {rows.lower_bound(id)};
+   }
+};
+
+table make_table(const std::vector<uint64_t>& seeds)
+{
+   table drops;
+   for (uint64_t seed : seeds) {
+      drops.rows.emplace(seed, drop{seed});
+   }
+   return drops;
+}
+
+void test_visits_in_order()
+{
+   table                 drops = make_table({1, 2, 3, 10, 20});
+   std::vector<uint64_t> visited;
+   for_each_drop(drops, std::vector<uint64_t>{1, 3, 20}, [&](auto itr) {
+      visited.push_back(itr->seed);
+      return drops.end();
+   });
+   EXPECT(visited == (std::vector<uint64_t>{1, 3, 20}));
+   EXPECT(drops.lookups == 3);
+}
+
+void test_follows_next_row()
+{
+   table drops = make_table({1, 2, 3, 10, 20});
+   for_each_drop(drops, std::vector<uint64_t>{1, 2, 3, 20}, [&](auto itr) {
+      return table::iterator{std::next(itr.itr)};
+   });
+   // 2 and 3 follow the previous row, 20 does not follow 3
+   EXPECT(drops.lookups == 2);
+}
+
+void test_rejects_invalid_ids()
+{
+   table drops = make_table({1, 2, 3});
+   auto  visit = [&](auto) { return drops.end(); };
+   EXPECT_ABORT(for_each_drop(drops, std::vector<uint64_t>{1, 1}, visit), "Drop 1 was provided more than once.");
+   EXPECT_ABORT(for_each_drop(drops, std::vector<uint64_t>{2, 1}, visit), "Drop 1 was provided more than once.");
+   EXPECT_ABORT(for_each_drop(drops, std::vector<uint64_t>{4}, visit), "Drop 4 not found");
+   EXPECT_ABORT(for_each_drop(drops, std::vector<uint64_t>{0}, visit), "Drop 0 not found");
+}
+
+void test_messages()
+{
+   EXPECT_ABORT(check_drop(false, drop_error::not_owned, 7), "Drop 7 does not belong to account.");
+   EXPECT_ABORT(check_drop(false, drop_error::not_owned_transfer, 7), "Account does not own drop7");
+   EXPECT_ABORT(check_drop(false, drop_error::not_bound, 7), "Drop 7 is not bound.");
+   EXPECT_ABORT(check_drop(false, drop_error::already_bound, 7), "Drop 7 is already bound.");
+   EXPECT_ABORT(check_drop(false, drop_error::bound_transfer, 7), "Drop 7 is bound and cannot be transferred");
+   EXPECT_ABORT(check_drop(false, drop_error::no_owner_index, 7), "Drop 7 has no owner index entry.");
+   check_drop(true, drop_error::not_found, 7);
+}
+
+} // namespace
+
+int main()
+{
+   test_visits_in_order();
+   test_follows_next_row();
+   test_rejects_invalid_ids();
+   test_messages();
+   return dropstest::finish("visit_test");
+}
@@ -16,12 +16,16 @@ checksum256 oracle::compute_epoch_value(uint64_t epoch)
    auto                 reveal_itr = reveal_idx.find(epoch);
    check(reveal_itr != reveal_idx.end(), "Epoch has no reveal values?");
 
-   // Accumulator for all reveal values
-   std::vector<std::string> reveals;
+   // Accumulator for all reveal values, released once the value is computed
+   scratch_scope                  scratch;
+   scratch_vector<scratch_string> reveals;
 
    // Iterate over reveals and build a vector containing them all
+   const std::string prefix = std::to_string(epoch);
+   size_t            length = prefix.length();
    while (reveal_itr != reveal_idx.end() && reveal_itr->epoch == epoch) {
-      reveals.push_back(reveal_itr->reveal);
+      reveals.emplace_back(reveal_itr->reveal.begin(), reveal_itr->reveal.end());
+      length += reveal_itr->reveal.length();
       reveal_itr++;
    }
 
@@ -29,7 +33,9 @@ checksum256 oracle::compute_epoch_value(uint64_t epoch)
    sort(reveals.begin(), reveals.end());
 
    // Combine the epoch, drops, and reveals into a single string
-   string result = std::to_string(epoch);
+   scratch_string result;
+   result.reserve(length);
+   result.append(prefix.begin(), prefix.end());
    for (const auto& reveal : reveals)
       result += reveal;
 
@@ -40,13 +46,24 @@ checksum256 oracle::compute_epoch_value(uint64_t epoch)
 checksum256 oracle::compute_epoch_drops_value(uint64_t epoch, uint64_t seed)
 {
    // Load the drops
-   drops::drop_table drops(drops_contract, drops_contract.value);
-   auto              drops_itr = drops.find(seed);
-   check(drops_itr != drops.end(), "Drop not found");
+   drops::state_table state(drops_contract, drops_contract.value);
+   auto               state_itr = state.find(1);
+   drops::drop_row    drop;
+   if (state_itr->storage_mode() == storage_owner) {
+      // Drops scoped by owner are located through the seed table
+      drops::seed_table seed_owners(drops_contract, drops_contract.value);
+      auto              seed_itr = seed_owners.find(seed);
+      check(seed_itr != seed_owners.end(), "Drop not found");
+      drops::owner_drop_table drops(drops_contract, seed_itr->owner.value);
+      drop = drops.get(seed, "Drop not found");
+   } else {
+      drops::drop_table drops(drops_contract, drops_contract.value);
+      drop = drops.get(seed, "Drop not found");
+   }
 
    // Ensure this drops was valid for the given epoch
    // A drops must be created before or during the provided epoch
-   check(drops_itr->epoch <= epoch, "Drop was generated after this epoch and is not valid for computation.");
+   check(drop.epoch <= epoch, "Drop was generated after this epoch and is not valid for computation.");
 
    // Load the epoch drops value
    oracle::epoch_table oracle_epoch(_self, _self.value);
@@ -74,7 +91,11 @@ checksum256 oracle::compute_last_epoch_drops_value(uint64_t drops)
    return compute_epoch_drops_value(epoch, drops);
 }
 
-[[eosio::action]] checksum256 oracle::computeepoch(uint64_t epoch) { return compute_epoch_value(epoch); }
+[[eosio::action]] checksum256 oracle::computeepoch(uint64_t epoch)
+{
+   [[maybe_unused]] memory_report report;
+   return compute_epoch_value(epoch);
+}
 
 [[eosio::action]] checksum256 oracle::cmplastepoch(uint64_t drops, name contract)
 {
@@ -129,6 +150,8 @@ void oracle::ensure_epoch_advance(drops::state_row state)
 
 [[eosio::action]] void oracle::reveal(name oracle, uint64_t epoch, string reveal)
 {
+   [[maybe_unused]] memory_report report;
+
    require_auth(oracle);
 
    // Retrieve contract state from drops contract
@@ -200,6 +223,8 @@ void oracle::ensure_epoch_advance(drops::state_row state)
 
 [[eosio::action]] void oracle::finishreveal(uint64_t epoch)
 {
+   [[maybe_unused]] memory_report report;
+
    drops::epoch_table epochs(drops_contract, drops_contract.value);
    auto               epoch_itr = epochs.find(epoch);
    check(epoch_itr != epochs.end(), "Epoch does not exist");
@@ -1,10 +1,42 @@
 import {APIClient} from '@wharfkit/antelope'
 import {RoborovskiClient} from '@wharfkit/roborovski'
-import {Name, Serializer} from '@wharfkit/session'
+import {Asset, Name, Serializer, Session, type TransactResult} from '@wharfkit/session'
+import {WalletPluginPrivateKey} from '@wharfkit/wallet-plugin-privatekey'
+
+// Usage:
+//
+//   bun scripts/performance.ts
+//     Dumps txid, block time and CPU usage of past transfers to testing.gm
+//
+//   bun scripts/performance.ts compare
+//     Generates drops in batches of increasing size on a baseline and a
+//     candidate deployment and prints the CPU used per drop by each. Set
+//     NODE_URL, ACTOR, PRIVATE_KEY, BASELINE and CANDIDATE, and optionally
+//     BATCHES (default 1,100,1000,5000), ROUNDS (default 3) and QUANTITY, the
+//     EOS sent per drop (default 0.0100 EOS, the change is credited back).
+//
+//   bun scripts/performance.ts storage
+//     Compares a deployment using storage_global (BASELINE) with one using
+//     storage_owner (CANDIDATE). For each size in DROPS (default 1,100,1000)
+//     drops are generated and then transferred to RECIPIENT in one action,
+//     and the contract RAM used per generated drop and the CPU billed per
+//     transferred drop are printed. Takes the same variables as compare.
+//
+//   bun scripts/performance.ts memory
+//     Generates DROPS drops (default 5000) in a single action on BASELINE and
+//     CANDIDATE, both built with make contract/drops/debug, and prints the CPU
+//     and the peak linear memory the debug build reports in its console. The
+//     node must run with contracts-console enabled.
+//
+//   bun scripts/performance.ts bind
+//     For each size in DROPS (default 1,100,1000), generates that many drops on
+//     BASELINE and CANDIDATE, binds them in one action and unbinds them again
+//     with unbind and a transfer with the "unbind" memo in one transaction,
+//     and prints the CPU billed per drop for the bind and the unbind.
 
 // Setup an APIClient
 const client = new APIClient({
-    url: 'https://jungle4.greymass.com',
+    url: process.env.NODE_URL || 'https://jungle4.greymass.com',
 })
 
 // Setup the API
@@ -49,4 +81,241 @@ async function get2() {
     }
 }
 
-await get()
+// Peak linear memory printed by a DROPS_DEBUG_MEMORY build, see arena.hpp
+function peakMemory(traces: {receiver: string; console: string}[], contract: string): string {
+    const output = traces
+        .filter((trace) => trace.receiver === contract)
+        .map((trace) => trace.console)
+        .join('')
+    const match = output.match(/peak linear memory: (\d+) bytes/)
+    return match ? match[1] : ''
+}
+
+interface Measurement {
+    // CPU billed for the whole transaction, including the token transfer
+    billed: number
+    // Time spent in the notification handled by the contract
+    elapsed: number
+    // Peak linear memory reported by a debug build, empty for release builds
+    memory: string
+}
+
+async function generate(session: Session, contract: string, drops: number): Promise<Measurement> {
+    const quantity = Asset.from(process.env.QUANTITY || '0.0100 EOS')
+    const data = Array.from(crypto.getRandomValues(new Uint8Array(32)))
+        .map((byte) => byte.toString(16).padStart(2, '0'))
+        .join('')
+    const result = await session.transact({
+        action: {
+            account: 'eosio.token',
+            name: 'transfer',
+            authorization: [session.permissionLevel],
+            data: {
+                from: session.actor,
+                to: contract,
+                quantity: Asset.fromUnits(Number(quantity.units) * drops, quantity.symbol),
+                memo: `${drops},${data}`,
+            },
+        },
+    })
+    // Traces are returned flat, notifications and inline actions included
+    const processed = result.response?.processed
+    const elapsed = processed.action_traces
+        .filter((trace) => trace.receiver === contract)
+        .reduce((total, trace) => total + Number(trace.elapsed), 0)
+    return {
+        billed: Number(processed.receipt.cpu_usage_us),
+        elapsed,
+        memory: peakMemory(processed.action_traces, contract),
+    }
+}
+
+async function createSession(): Promise<Session> {
+    const {ACTOR, PRIVATE_KEY, BASELINE, CANDIDATE} = process.env
+    if (!ACTOR || !PRIVATE_KEY || !BASELINE || !CANDIDATE) {
+        throw new Error('ACTOR, PRIVATE_KEY, BASELINE and CANDIDATE must be set')
+    }
+    const info = await client.v1.chain.get_info()
+    return new Session({
+        actor: ACTOR,
+        permission: 'active',
+        chain: {id: info.chain_id, url: String(client.provider.url)},
+        walletPlugin: new WalletPluginPrivateKey(PRIVATE_KEY),
+    })
+}
+
+async function memory() {
+    const {BASELINE, CANDIDATE} = process.env as Record<string, string>
+    const session = await createSession()
+    const drops = Number(process.env.DROPS || 5000)
+
+    console.log('contract,drops,billed_us,elapsed_us,peak_memory_bytes')
+    for (const contract of [BASELINE, CANDIDATE]) {
+        const {billed, elapsed, memory} = await generate(session, contract, drops)
+        console.log([contract, drops, billed, elapsed, memory].join(','))
+    }
+}
+
+async function compare() {
+    const {BASELINE, CANDIDATE} = process.env as Record<string, string>
+    const session = await createSession()
+    const batches = (process.env.BATCHES || '1,100,1000,5000').split(',').map(Number)
+    const rounds = Number(process.env.ROUNDS || 3)
+
+    console.log('contract,drops,billed_us,elapsed_us,billed_us_per_drop,elapsed_us_per_drop')
+    for (const drops of batches) {
+        for (const contract of [BASELINE, CANDIDATE]) {
+            // The median of the rounds is reported, the first action after a
+            // deployment also pays for compiling the contract
+            const measurements: Measurement[] = []
+            for (let round = 0; round < rounds; round++) {
+                measurements.push(await generate(session, contract, drops))
+            }
+            const median = (values: number[]) => values.sort((a, b) => a - b)[values.length >> 1]
+            const billed = median(measurements.map((m) => m.billed))
+            const elapsed = median(measurements.map((m) => m.elapsed))
+            console.log(
+                [
+                    contract,
+                    drops,
+                    billed,
+                    elapsed,
+                    (billed / drops).toFixed(2),
+                    (elapsed / drops).toFixed(2),
+                ].join(',')
+            )
+        }
+    }
+}
+
+// Ids of up to limit drops the actor holds, from the table of the storage mode
+async function ownedDrops(contract: string, owner: string, limit: number): Promise<string[]> {
+    const state = await client.v1.chain.get_table_rows({code: contract, table: 'state', limit: 1})
+    const storage = Number(state.rows[0]?.storage || 0)
+    const query =
+        storage === 1
+            ? {code: contract, scope: owner, table: 'ownerdrop', limit}
+            : {
+                  code: contract,
+                  table: 'drop',
+                  index_position: 'secondary' as const,
+                  key_type: 'i64' as const,
+                  lower_bound: Name.from(owner).value,
+                  upper_bound: Name.from(owner).value,
+                  limit,
+              }
+    const result = await client.v1.chain.get_table_rows(query)
+    return result.rows.filter((row) => !row.bound).map((row) => String(row.seed))
+}
+
+async function storage() {
+    const {BASELINE, CANDIDATE, RECIPIENT} = process.env as Record<string, string>
+    if (!RECIPIENT) {
+        throw new Error('RECIPIENT must be set')
+    }
+    const session = await createSession()
+    const sizes = (process.env.DROPS || '1,100,1000').split(',').map(Number)
+
+    console.log('contract,drops,ram_bytes_per_drop,transfer_billed_us,transfer_billed_us_per_drop')
+    for (const drops of sizes) {
+        for (const contract of [BASELINE, CANDIDATE]) {
+            // RAM of the contract account, includes its share of new account rows
+            const before = await client.v1.chain.get_account(contract)
+            await generate(session, contract, drops)
+            const after = await client.v1.chain.get_account(contract)
+            const ram = Number(after.ram_usage) - Number(before.ram_usage)
+
+            const ids = await ownedDrops(contract, String(session.actor), drops)
+            const result = await session.transact({
+                action: {
+                    account: contract,
+                    name: 'transfer',
+                    authorization: [session.permissionLevel],
+                    data: {from: session.actor, to: RECIPIENT, drops_ids: ids, memo: ''},
+                },
+            })
+            const billed = Number(result.response?.processed.receipt.cpu_usage_us)
+            console.log(
+                [
+                    contract,
+                    drops,
+                    (ram / drops).toFixed(1),
+                    billed,
+                    (billed / ids.length).toFixed(2),
+                ].join(',')
+            )
+        }
+    }
+}
+
+async function bind() {
+    const {BASELINE, CANDIDATE} = process.env as Record<string, string>
+    const session = await createSession()
+    const sizes = (process.env.DROPS || '1,100,1000').split(',').map(Number)
+    const quantity = Asset.from(process.env.QUANTITY || '0.0100 EOS')
+    const billed = (result: TransactResult) => Number(result.response?.processed.receipt.cpu_usage_us)
+
+    console.log('contract,drops,bind_billed_us,unbind_billed_us,bind_us_per_drop,unbind_us_per_drop')
+    for (const drops of sizes) {
+        for (const contract of [BASELINE, CANDIDATE]) {
+            await generate(session, contract, drops)
+            const ids = await ownedDrops(contract, String(session.actor), drops)
+
+            const bound = await session.transact({
+                action: {
+                    account: contract,
+                    name: 'bind',
+                    authorization: [session.permissionLevel],
+                    data: {owner: session.actor, drops_ids: ids},
+                },
+            })
+            // The unbind request and its payment, the change is credited back
+            const unbound = await session.transact({
+                actions: [
+                    {
+                        account: contract,
+                        name: 'unbind',
+                        authorization: [session.permissionLevel],
+                        data: {owner: session.actor, drops_ids: ids},
+                    },
+                    {
+                        account: 'eosio.token',
+                        name: 'transfer',
+                        authorization: [session.permissionLevel],
+                        data: {
+                            from: session.actor,
+                            to: contract,
+                            quantity: Asset.fromUnits(
+                                Number(quantity.units) * ids.length,
+                                quantity.symbol
+                            ),
+                            memo: 'unbind',
+                        },
+                    },
+                ],
+            })
+            console.log(
+                [
+                    contract,
+                    ids.length,
+                    billed(bound),
+                    billed(unbound),
+                    (billed(bound) / ids.length).toFixed(2),
+                    (billed(unbound) / ids.length).toFixed(2),
+                ].join(',')
+            )
+        }
+    }
+}
+
+if (process.argv[2] === 'compare') {
+    await compare()
+} else if (process.argv[2] === 'storage') {
+    await storage()
+} else if (process.argv[2] === 'memory') {
+    await memory()
+} else if (process.argv[2] === 'bind') {
+    await bind()
+} else {
+    await get()
+}
@@ -0,0 +1,28 @@
+import type { NameType } from '@wharfkit/session';
+import { client, dropsContract } from './wharf';
+
+export interface AccountEpoch {
+	epoch: number;
+	drops: number;
+}
+
+// Drops held per epoch, recorded in the epochs of the account row. The row is
+// decoded by the node since the generated bindings predate the epochs field.
+export async function loadAccountEpochs(account: NameType): Promise<AccountEpoch[]> {
+	const result = await client.v1.chain.get_table_rows({
+		code: dropsContract.account,
+		scope: dropsContract.account,
+		table: 'account',
+		lower_bound: account,
+		upper_bound: account,
+		limit: 1
+	});
+	const row = result.rows[0];
+	if (!row || !row.epochs) {
+		return [];
+	}
+	return row.epochs.map((entry: { epoch: number; drops: number }) => ({
+		epoch: Number(entry.epoch),
+		drops: Number(entry.drops)
+	}));
+}
@@ -1,5 +1,6 @@
-import type { Asset, Int64 } from '@wharfkit/session';
-import { systemContract } from './wharf';
+import { Asset, type Int64 } from '@wharfkit/session';
+import { client, dropsContract, systemContract } from './wharf';
+import { ramInventoryRefill } from './constants';
 
 export function get_bancor_input(out_reserve: Asset, inp_reserve: Asset, out: number): Int64 {
 	const ob = out_reserve.units;
@@ -34,3 +35,21 @@ export async function getRamPriceMinusFee(): Promise<number | undefined> {
 		return cost_plus_fee / 10000;
 	}
 }
+
+// Price per byte the drops contract charges for the RAM it allocates, the
+// quote recorded at its last refill. Read untyped since the generated bindings
+// predate ram_price. Without a recorded quote every allocation buys its own
+// RAM, so the market price applies.
+export async function getAllocationPrice(): Promise<number | undefined> {
+	const result = await client.v1.chain.get_table_rows({
+		code: dropsContract.account,
+		scope: dropsContract.account,
+		table: 'state',
+		limit: 1
+	});
+	const price = result.rows[0]?.ram_price;
+	if (price && Number(Asset.from(price).units) > 0) {
+		return Number(Asset.from(price).units) / ramInventoryRefill;
+	}
+	return getRamPrice();
+}
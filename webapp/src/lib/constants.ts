@@ -1,4 +1,7 @@
-export const sizeDropRow = 289;
+export const sizeDropRow = 273;
 export const sizeDropRowPurchase = sizeDropRow + 3;
-export const sizeAccountRow = 124;
-export const sizeStatRow = 412;
+export const sizeAccountRow = 133;
+export const sizeStatRow = 12;
+
+// RAM bytes state.ram_price is quoted for, ram_inventory_refill in the contract
+export const ramInventoryRefill = 1048576;
@@ -0,0 +1,26 @@
+import { Asset, type NameType } from '@wharfkit/session';
+import type { Contract } from '@wharfkit/contract';
+import { contractKit, dropsContract } from './wharf';
+
+export interface GenerateQuote {
+	ramBytes: number;
+	cost: Asset;
+}
+
+// Loaded with the deployed ABI, the generated bindings predate genquote
+let deployed: Promise<Contract> | undefined;
+
+// Exact payment the contract charges for a generate in its current state,
+// including an account row it takes over from another payer
+export async function loadGenerateQuote(
+	owner: NameType,
+	amount: number,
+	dataLength: number
+): Promise<GenerateQuote> {
+	if (!deployed) {
+		deployed = contractKit.load(dropsContract.account);
+	}
+	const contract = await deployed;
+	const result = await contract.readonly('genquote', { owner, amount, data_length: dataLength });
+	return { ramBytes: Number(result.ram_bytes), cost: Asset.from(result.cost) };
+}